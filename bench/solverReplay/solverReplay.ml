@@ -0,0 +1,158 @@
+(* dune exec bench/solverReplay/solverReplay.exe -- trace.marshalled [cost] [solver...] *)
+(* The trace is also replayed with variables compared by their names to compare td3 with and without solvers.td3.intern. *)
+(* Record a trace with: goblint --set dbg.solver-trace trace.marshalled ... *)
+
+open Goblint_lib
+open ConstrSys
+open Goblint_solver
+open Benchmark
+
+(** Constraint system replaying [trace], where each join, comparison etc. of values additionally costs [cost] loop iterations. *)
+module Replay (T: sig val trace: SolverTrace.t val cost: int end) =
+struct
+  open T
+
+  type v = int
+  type d = int
+
+  module Var =
+  struct
+    type t = int
+    let equal = Int.equal
+    let hash = Hashtbl.hash
+    let compare = Int.compare
+    let pretty_trace () x = GoblintCil.Pretty.text trace.names.(x)
+    let printXml f x = BatPrintf.fprintf f "%s" (XmlUtil.escape trace.names.(x))
+    let var_id x = trace.names.(x)
+    let node _ = MyCFG.dummy_node
+    let relift x = x
+    let is_write_only _ = false
+  end
+
+  let burn () =
+    for _ = 1 to cost do
+      ignore (Sys.opaque_identity ())
+    done
+
+  module Dom =
+  struct
+    let n =
+      let max_op acc = function
+        | SolverTrace.Get _ -> acc
+        | Side (_, v) -> max acc v
+      in
+      let max_eval acc (e: SolverTrace.eval) = Array.fold_left max_op (max acc e.result) e.ops in
+      let max_start = Array.fold_left (fun acc (_, v) -> max acc v) 0 trace.start in
+      2 + Array.fold_left (Array.fold_left max_eval) max_start trace.evals
+
+    include Lattice.Chain (struct let n () = n let names = string_of_int end)
+
+    let equal x y = burn (); equal x y
+    let leq x y = burn (); leq x y
+    let join x y = burn (); join x y
+    let widen x y = burn (); widen x y
+    let meet x y = burn (); meet x y
+    let narrow x y = burn (); narrow x y
+  end
+
+  (** Number of evaluations of each right-hand side so far. *)
+  let counts = Array.make (Array.length trace.names) 0
+
+  let system x =
+    let evals = trace.evals.(x) in
+    if Array.length evals = 0 then
+      None
+    else
+      Some (fun get set ->
+          let k = counts.(x) in
+          counts.(x) <- k + 1;
+          let e = evals.(min k (Array.length evals - 1)) in (* repeat last evaluation if the solver needs more *)
+          Array.iter (function
+              | SolverTrace.Get y -> ignore (get y)
+              | Side (y, v) -> set y v
+            ) e.ops;
+          e.result
+        )
+
+  let sys_change _ = {obsolete = []; delete = []; reluctant = []; restart = []}
+
+  let reset () = Array.fill counts 0 (Array.length counts) 0
+end
+
+(** Constraint system replaying [trace] with variables hashed and compared by their names, like (node, context) pairs. *)
+module Named (T: sig val trace: SolverTrace.t val cost: int end) =
+struct
+  module R = Replay (T)
+
+  type v = {
+    index: int;
+    name: string;
+  }
+  type d = R.d
+
+  module Var =
+  struct
+    type t = v
+    let equal x y = String.equal x.name y.name
+    let hash x = Hashtbl.hash x.name
+    let compare x y = String.compare x.name y.name
+    let pretty_trace () x = GoblintCil.Pretty.text x.name
+    let printXml f x = BatPrintf.fprintf f "%s" (XmlUtil.escape x.name)
+    let var_id x = x.name
+    let node _ = MyCFG.dummy_node
+    let relift x = x
+    let is_write_only _ = false
+  end
+
+  module Dom = R.Dom
+
+  let vars = Array.mapi (fun index name -> {index; name = Printf.sprintf "%s (%d)" name index}) T.trace.names (* names might not be unique *)
+
+  let system x =
+    Option.map (fun f get set ->
+        f (fun y -> get vars.(y)) (fun y d -> set vars.(y) d)
+      ) (R.system x.index)
+
+  let sys_change _ = {obsolete = []; delete = []; reluctant = []; restart = []}
+
+  let reset = R.reset
+end
+
+module PostSolverArg =
+struct
+  let should_prune = false
+  let should_verify = false
+  let should_warn = false
+  let should_save_run = false
+end
+
+let () =
+  let trace = SolverTrace.load Sys.argv.(1) in
+  let cost = if Array.length Sys.argv > 2 then int_of_string Sys.argv.(2) else 0 in
+  let solvers = if Array.length Sys.argv > 3 then Array.to_list (Array.sub Sys.argv 3 (Array.length Sys.argv - 3)) else ["td3"; "slr3"; "slr3t"] in
+  GobConfig.set_int "dbg.solver-stats-interval" 0;
+  AfterConfig.run ();
+  let module RS = Replay (struct let trace = trace let cost = cost end) in
+  let module VH = BatHashtbl.Make (RS.Var) in
+  let start = Array.to_list trace.start in
+  let interesting = Array.to_list trace.interesting in
+  let run name =
+    let module Sol = (val Selector.choose_solver name: GenericEqIncrSolver) in
+    let module F = Sol (PostSolverArg) (RS) (VH) in
+    (name, (fun () -> RS.reset (); ignore (F.solve start interesting None)), ())
+  in
+  Printf.printf "%d variables, %d evaluations\n" (Array.length trace.names) (Array.fold_left (fun acc es -> acc + Array.length es) 0 trace.evals);
+  tabulate (latencyN 5L (List.map run solvers));
+  let module NS = Named (struct let trace = trace let cost = cost end) in
+  let module NH = BatHashtbl.Make (NS.Var) in
+  let nstart = List.map (fun (x, d) -> (NS.vars.(x), d)) start in
+  let ninteresting = List.map (fun x -> NS.vars.(x)) interesting in
+  let run_named name intern =
+    GobConfig.set_bool "solvers.td3.intern" intern;
+    Td3.after_config ();
+    let module Sol = (val Selector.choose_solver "td3": GenericEqIncrSolver) in
+    let module F = Sol (PostSolverArg) (NS) (NH) in
+    (name, (fun () -> NS.reset (); ignore (F.solve nstart ninteresting None)), ())
+  in
+  print_endline "Variables compared by names:";
+  tabulate (latencyN 5L [run_named "td3" false; run_named "td3 (intern)" true])
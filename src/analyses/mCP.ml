@@ -316,6 +316,11 @@ struct
                 let q' = Queries.IterSysVars (vq, fi') in
                 f ~q:q' () t
               ) @@ spec_list man.local
+          | Queries.IterComponents fi ->
+            (* IterComponents is special: answered by MCP itself with the unlifted component of each analysis *)
+            iter (fun (_, (module S: MCPSpec), d) ->
+                fi (S.name ()) d
+              ) @@ spec_list man.local
           (* | EvalInt e ->
              (* TODO: only query others that actually respond to EvalInt *)
              (* 2x speed difference on SV-COMP nla-digbench-scaling/ps6-ll_valuebound5.c *)
@@ -9,16 +9,18 @@ struct
 
   module A =
   struct
-    include MHP
-    let name () = "mhp"
-    let may_race = MHP.may_happen_in_parallel
-    let should_print {tid; created; must_joined} =
+    include MHP.Numbered
+    let may_race = MHP.Numbered.may_happen_in_parallel
+    let should_print {mhp = MHP.{created; must_joined; _}; _} =
       GobConfig.get_bool "dbg.full-output" ||
       (not (ConcDomain.ThreadSet.is_empty created) ||
        not (ConcDomain.ThreadSet.is_empty must_joined))
   end
 
-  let access man _: MHP.t = MHP.current (Analyses.ask_of_man man)
+  let init _ =
+    MHP.Index.reset ()
+
+  let access man _: A.t = MHP.Numbered.current (Analyses.ask_of_man man)
 end
 
 let _ =
@@ -215,7 +215,8 @@ struct
   let init marshal =
     safe := 0;
     vulnerable := 0;
-    unsafe := 0
+    unsafe := 0;
+    Access.Intern.reset ()
 
   let side_vars man memo =
     match memo with
@@ -315,11 +316,11 @@ struct
       let node = Option.get !Node.current_node in
       let add_access conf voffs =
         let acc = part_access (Option.map fst voffs) in
-        Access.add ~side:(side_access oman {conf; kind; node; exp; acc}) ~side_empty:(side_access_empty oman) exp voffs;
+        Access.add ~side:(side_access oman (Access.intern {conf; kind; node; exp; acc})) ~side_empty:(side_access_empty oman) exp voffs;
       in
       let add_access_struct conf ci =
         let acc = part_access None in
-        Access.add_one ~side:(side_access oman {conf; kind; node; exp; acc}) (`Type (TSComp (ci.cstruct, ci.cname, [])), `NoOffset)
+        Access.add_one ~side:(side_access oman (Access.intern {conf; kind; node; exp; acc})) (`Type (TSComp (ci.cstruct, ci.cname, [])), `NoOffset)
       in
       let has_escaped g = oman.ask (Queries.MayEscape g) in
       (* The following function adds accesses to the lval-set ls
@@ -377,7 +378,7 @@ struct
       let node = Option.get !Node.current_node in
       let vo = Some f in
       let acc = Obj.obj (man.ask (PartAccess (Memory {exp; var_opt=vo; kind}))) in
-      side_access man {conf; kind; node; exp; acc} ((`Var f), `NoOffset) ;
+      side_access man (Access.intern {conf; kind; node; exp; acc}) ((`Var f), `NoOffset) ;
     );
     man.local
 
@@ -390,7 +391,9 @@ struct
         (Pretty.dprintf "unsafe: %d" !unsafe, None);
         (Pretty.dprintf "total memory locations: %d" total, None);
       ];
-    )
+    );
+    if !Access.intern_enabled then
+      Logs.debug "%a" Access.Intern.pretty_stats ()
 end
 
 let _ =
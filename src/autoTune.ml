@@ -180,6 +180,44 @@ let disableIntervalContextsInRecursiveFunctions () =
       )
     )
 
+(** Calls any function or contains inline assembly. *)
+class findCallsVisitor = object
+  inherit nopCilVisitor
+
+  method! vinst = function
+    | Call _
+    | Asm _ -> raise Found
+    | _ -> SkipChildren
+end
+
+let isLeaf fd =
+  match visitCilFunction (new findCallsVisitor) fd with
+  | _ -> true
+  | exception Found -> false
+
+(** Whether a relational analysis is active, which can relate a function's result to its arguments. *)
+let isRelationalActive () =
+  List.exists (fun a -> List.mem a ["apron"; "affeq"; "lin2vareq"]) (get_string_list "ana.activated")
+
+(** Analyze leaf functions, which are called from multiple sites, only once per pointer context.
+    This is only a context reduction, unless a relational analysis is active:
+    then the function's effect on non-pointer values is a relational summary, which is instantiated at each call site by combine.
+    Without a relational analysis nothing is changed, because dropping non-pointer contexts would only lose precision. *)
+let leafFunctionSummaries () =
+  if not (isRelationalActive ()) then
+    Logs.info "no relational analysis active, leaf functions keep their contexts"
+  else (
+    let mainfuns = get_string_list "mainfun" in
+    (ResettableLazy.force functionCallMaps).calling |> FunctionCallMap.iter (fun f _ ->
+        match Cilfacade.find_varinfo_fundec f with
+        | fd when timesCalled f > 1 && not (List.mem f.vname mainfuns) && isLeaf fd ->
+          Logs.info "function %s is a leaf, disable non-pointer contexts" f.vname;
+          f.vattr <- addAttributes (f.vattr) [Attr ("goblint_context",[AStr "base.no-non-ptr"; AStr "base.no-int"; AStr "relation.no-context"])]
+        | _ -> ()
+        | exception Not_found -> ()
+      )
+  )
+
 let hasFunction pred =
   let relevant_static var =
     Goblint_backtrace.wrap_val ~mark:(Cilfacade.FunVarinfo var) @@ fun () ->
@@ -568,6 +606,10 @@ let chooseConfig file =
   let options = if isActivated "octagon" && not (isTerminationTask ()) then (apronOctagonOption factors file)::options else options in
   let options = if isActivated "wideningThresholds" then (wideningOption factors file)::options else options in
 
-  List.iter (fun o -> o.activate ()) @@ chooseFromOptions (totalTarget - fileCompplexity) options
+  List.iter (fun o -> o.activate ()) @@ chooseFromOptions (totalTarget - fileCompplexity) options;
+
+  (* After options, which may activate apron. *)
+  if isActivated "leafSummaries" then
+    leafFunctionSummaries ()
 
 let reset_lazy () = ResettableLazy.reset functionCallMaps
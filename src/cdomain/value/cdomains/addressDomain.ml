@@ -7,6 +7,19 @@ module M = Messages
 module Mval_outer = Mval
 module SD = StringDomain
 
+type address_set_domain = Projective | Bitset
+
+let address_set_domain: address_set_domain ResettableLazy.t =
+  ResettableLazy.from_fun (fun () ->
+      match GobConfig.get_string "ana.base.addresses.domain" with
+      | "projective" -> Projective
+      | "bitset" -> Bitset
+      | _ -> failwith "ana.base.addresses.domain: illegal value"
+    )
+
+let reset_lazy () =
+  ResettableLazy.reset address_set_domain
+
 
 module AddressBase (Mval: Printable.S) =
 struct
@@ -184,7 +197,33 @@ struct
   (* module H = HoareDomain.SetEM (Addr) *)
   (* Hoare set for bucket doesn't play well with StrPtr limiting:
      https://github.com/goblint/analyzer/pull/808 *)
-  module AddressSet: SetDomain.S with type elt = Addr.t = DisjointDomain.ProjectiveSet (Addr) (OffsetSplit) (Addr.VariableRepr)
+  module ProjectiveAddressSet = DisjointDomain.ProjectiveSet (Addr) (OffsetSplit) (Addr.VariableRepr)
+
+  module Atomic =
+  struct
+    type elt = Addr.t
+
+    let enabled () = ResettableLazy.force address_set_domain = Bitset
+
+    (* Addresses without offset are alone in their OffsetSplit bucket, so they can be kept in a bitmap. *)
+    let is_atomic: elt -> bool = function
+      | Addr.Addr (_, `NoOffset)
+      | Addr.NullPtr
+      | Addr.UnknownPtr -> true
+      | Addr.Addr _
+      | Addr.StrPtr _ -> false
+
+    (* Within the bucket of a variable, OffsetSplit meets addresses with different offsets pairwise. *)
+    let atom_of: elt -> elt option = function
+      | Addr.Addr (v, _) -> Some (Addr.Addr (v, `NoOffset))
+      | Addr.StrPtr _
+      | Addr.NullPtr
+      | Addr.UnknownPtr -> None
+
+    let may_be_equal = J.may_be_equal
+  end
+
+  module AddressSet: SetDomain.S with type elt = Addr.t = BitsetDomain.Split (Addr) (ProjectiveAddressSet) (Atomic)
   include AddressSet
 
   let name () = Format.sprintf "address set (%s)" (Mval.name ())
@@ -1,6 +1,9 @@
 module type AddressDomain =
 sig
 
+  val reset_lazy: unit -> unit
+  (** Reset the cached configuration of the address set domain. *)
+
   module AddressBase (Mval: Printable.S):
   sig
     type t =
@@ -331,14 +331,19 @@ struct
     | Joint v -> v
     | Partitioned (e, (xl, xm, xr)) -> Val.join xl (Val.join xm xr)
 
+  (* physical equality first, parts are often shared *)
+  let val_equal x y = x == y || Val.equal x y
+  let val_join x y = if x == y then x else Val.join x y
+
   (** Ensures an array where all three Val are equal, is represented by an unpartitioned array *)
   let normalize = function
     | Joint v -> Joint v
     | (Partitioned (e, (xl, xm, xr)) as p) ->
-      if Val.equal xl xm && Val.equal xm xr then Joint xl
+      if val_equal xl xm && val_equal xm xr then Joint xl
       else p
 
   let leq (x:t) (y:t) =
+    x == y ||
     match x, y with
     | Joint x, Joint y -> Val.leq x y
     | Partitioned (e,(xl, xm, xr)), Joint y -> Val.leq xl y && Val.leq xm y && Val.leq xr y
@@ -353,13 +358,14 @@ struct
     | Joint x -> Val.is_top x
     | _-> false
 
-  let join (x:t) (y:t) = normalize @@
+  let join (x:t) (y:t) =
+    if x == y then x else normalize @@
     match x, y with
     | Joint x, Joint y -> Joint (Val.join x y)
-    | Partitioned (e,(xl, xm, xr)), Joint y -> Partitioned (e,(Val.join xl y, Val.join xm y, Val.join xr y))
-    | Joint x, Partitioned (e,(yl, ym, yr)) -> Partitioned (e,(Val.join x yl, Val.join x ym, Val.join x yr))
+    | Partitioned (e,(xl, xm, xr)), Joint y -> Partitioned (e,(val_join xl y, val_join xm y, val_join xr y))
+    | Joint x, Partitioned (e,(yl, ym, yr)) -> Partitioned (e,(val_join x yl, val_join x ym, val_join x yr))
     | Partitioned (e,(xl, xm, xr)), Partitioned (e',(yl, ym, yr)) ->
-      if CilType.Exp.equal e e' then Partitioned (e,(Val.join xl yl, Val.join xm ym, Val.join xr yr))
+      if CilType.Exp.equal e e' then Partitioned (e,(val_join xl yl, val_join xm ym, val_join xr yr))
       else Joint (Val.join (join_of_all_parts x) (join_of_all_parts y))
 
   let widen (x:t) (y:t) = normalize @@ match x,y with
@@ -502,7 +508,8 @@ struct
       else
         (* check if one part covers the entire array, so we can drop partitioning *)
         begin
-          let e_must_bigger_max_index =
+          (* evaluated only as far as needed *)
+          let e_must_bigger_max_index = lazy (
             match length with
             | Some l ->
               begin
@@ -513,14 +520,16 @@ struct
                 | None -> false
               end
             | _ -> false
+          )
           in
-          let e_must_less_zero =
+          let e_must_less_zero = lazy (
             VDQ.eval_int_binop (module BoolDomain.MustBool) Lt ask.eval_int e Cil.zero (* TODO: untested *)
+          )
           in
-          if e_must_bigger_max_index then
+          if Lazy.force e_must_bigger_max_index then
             (* Entire array is covered by left part, dropping partitioning. *)
             Joint xl
-          else if e_must_less_zero then
+          else if Lazy.force e_must_less_zero then
             (* Entire array is covered by right value, dropping partitioning. *)
             Joint xr
           else
@@ -575,7 +584,7 @@ struct
         let isEqual = VDQ.must_be_equal ask.eval_int in
         match i with
         | Some i' when not use_last || not_allowed_for_part i' -> begin
-            let default =
+            let default = lazy (
               let left =
                 match VDQ.may_be_less ask.eval_int i' e with     (* (may i < e) ? xl : bot *) (* TODO: untested *)
                 | false -> xl
@@ -589,6 +598,7 @@ struct
                 | false -> xr
                 | _ -> lubIfNotBot xr in
               Partitioned (e, (left, middle, right))
+            )
             in
             if isEqual e i' then
               (*  e = _{must} i => update strongly *)
@@ -602,11 +612,11 @@ struct
                 else if Z.equal e'' (Z.succ i'') then
                   Partitioned (i', (xl, a, Val.join xm xr))
                 else
-                  default
+                  Lazy.force default
               | _ ->
-                default
+                Lazy.force default
             else
-              default
+              Lazy.force default
           end
         | Some i' ->
           if isEqual e i' then
@@ -577,31 +577,29 @@ module IntervalArith (Ints_t : IntOps.IntOps) = struct
     if Ints_t.equal x1 x2 then Some x1 else None
 
   let find_thresholds lower_or_upper =
-    let ts = if get_interval_threshold_widening_constants () = "comparisons" then lower_or_upper else WideningThresholds.thresholds in
-    ResettableLazy.force ts
+    let sorted = WideningThresholds.current_sorted () in
+    if get_interval_threshold_widening_constants () = "comparisons" then lower_or_upper sorted else sorted.WideningThresholds.constants
 
   let upper_threshold u max_ik =
     let u = Ints_t.to_bigint u in
     let max_ik' = Ints_t.to_bigint max_ik in
-    find_thresholds WideningThresholds.upper_thresholds
-    |> WideningThresholds.Thresholds.find_first_opt (fun x -> Z.compare u x <= 0)
+    WideningThresholds.find_geq (find_thresholds (fun s -> s.WideningThresholds.upper)) u
     |> BatOption.filter (fun x -> Z.compare x max_ik' <= 0)
     |> BatOption.map_default Ints_t.of_bigint max_ik
   let lower_threshold l min_ik =
     let l = Ints_t.to_bigint l in
     let min_ik' = Ints_t.to_bigint min_ik in
-    find_thresholds WideningThresholds.lower_thresholds
-    |> WideningThresholds.Thresholds.find_last_opt (fun x -> Z.compare l x >= 0)
+    WideningThresholds.find_leq (find_thresholds (fun s -> s.WideningThresholds.lower)) l
     |> BatOption.filter (fun x -> Z.compare x min_ik' >= 0)
     |> BatOption.map_default Ints_t.of_bigint min_ik
 
   let is_threshold t ts =
     let ts = find_thresholds ts in
     let t = Ints_t.to_bigint t in
-    WideningThresholds.Thresholds.mem t ts
+    WideningThresholds.mem ts t
 
-  let is_upper_threshold u = is_threshold u WideningThresholds.upper_thresholds
-  let is_lower_threshold l = is_threshold l WideningThresholds.lower_thresholds
+  let is_upper_threshold u = is_threshold u (fun s -> s.WideningThresholds.upper)
+  let is_lower_threshold l = is_threshold l (fun s -> s.WideningThresholds.lower)
 end
 
 module IntInvariant =
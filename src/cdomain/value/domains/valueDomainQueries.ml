@@ -55,6 +55,22 @@ type t = {
   is_multiple: is_multiple;
 }
 
+(** Memoize answers of [eval_int], such that repeated checks on the same expressions (e.g. of array partitioning) are evaluated once.
+    Only valid as long as the state which [eval_int] evaluates in does not change. *)
+let memo_eval_int (eval_int: eval_int): eval_int =
+  let memo = ref [] in
+  let size = ref 0 in
+  fun e ->
+    match List.find_opt (fun (e', _) -> e == e' || CilType.Exp.equal e e') !memo with
+    | Some (_, i) -> i
+    | None ->
+      let i = eval_int e in
+      if !size < 16 then ( (* few distinct expressions are checked repeatedly, keep lookup cheap *)
+        memo := (e, i) :: !memo;
+        incr size
+      );
+      i
+
 let eval_int_binop (module Bool: Lattice.S with type t = bool) binop (eval_int: eval_int) e1 e2: Bool.t =
   let e = Cilfacade.makeBinOp binop e1 e2 in
   let i = eval_int e in
@@ -66,47 +66,125 @@ let default_thresholds = Thresholds.of_list (
     List.map Z.of_int (thresh_neg @ thresh_pos @ [0])
   )
 
-let conditional_widening_thresholds = ResettableLazy.from_fun (fun () ->
-    let upper = ref default_thresholds in
-    let lower = ref default_thresholds in
-    let octagon = ref default_thresholds in
-    let thisVisitor = new extractThresholdsFromConditionsVisitor(upper,lower,octagon) in
-    visitCilFileSameGlobals thisVisitor (!Cilfacade.current_file);
-    !upper, !lower, !octagon)
-
-let upper_thresholds = ResettableLazy.map Tuple3.first conditional_widening_thresholds
-
-let lower_thresholds = ResettableLazy.map Tuple3.second conditional_widening_thresholds
-
-let octagon_thresholds = ResettableLazy.map Tuple3.third conditional_widening_thresholds
-
-
-class extractConstantsVisitor(widening_thresholds,widening_thresholds_incl_mul2) = object
-  inherit nopCilVisitor
+(** Thresholds of all kinds, collected in a single pass. *)
+type collected = {
+  upper: Thresholds.t ref;
+  lower: Thresholds.t ref;
+  octagon: Thresholds.t ref;
+  constants: Thresholds.t ref;
+  constants_incl_mul2: Thresholds.t ref;
+}
+
+let create_collected () = {
+  upper = ref default_thresholds;
+  lower = ref default_thresholds;
+  octagon = ref default_thresholds;
+  constants = ref Thresholds.empty;
+  constants_incl_mul2 = ref Thresholds.empty;
+}
+
+class extractThresholdsVisitor (c: collected) = object
+  inherit extractThresholdsFromConditionsVisitor(c.upper, c.lower, c.octagon) as conditions
 
   method! vexpr e =
     match e with
     | Const (CInt(i,ik,_)) ->
-      widening_thresholds := Thresholds.add i !widening_thresholds;
-      widening_thresholds_incl_mul2 := Thresholds.add i !widening_thresholds_incl_mul2;
+      addThreshold c.constants i;
+      addThreshold c.constants_incl_mul2 i;
       (* Adding double value of all constants so that we can establish for single variables that they are <= const *)
       (* This is e.g. needed for Apron. Done here where we still have the set representation to avoid expensive    *)
       (* deduplication and sorting on a list later *)
-      widening_thresholds_incl_mul2 := Thresholds.add (Z.mul (Z.of_int 2) i) !widening_thresholds_incl_mul2;
+      addThreshold c.constants_incl_mul2 (Z.mul (Z.of_int 2) i);
       DoChildren
-    | _ -> DoChildren
+    | _ -> conditions#vexpr e
 end
 
-let widening_thresholds = ResettableLazy.from_fun (fun () ->
-    let set = ref Thresholds.empty in
-    let set_incl_mul2 = ref Thresholds.empty in
-    let thisVisitor = new extractConstantsVisitor(set,set_incl_mul2) in
+let collected = ResettableLazy.from_fun (fun () ->
+    let c = create_collected () in
+    let thisVisitor = new extractThresholdsVisitor c in
     visitCilFileSameGlobals thisVisitor (!Cilfacade.current_file);
-    !set, !set_incl_mul2)
+    c)
+
+let upper_thresholds = ResettableLazy.map (fun c -> !(c.upper)) collected
+
+let lower_thresholds = ResettableLazy.map (fun c -> !(c.lower)) collected
+
+let octagon_thresholds = ResettableLazy.map (fun c -> !(c.octagon)) collected
+
+let thresholds = ResettableLazy.map (fun c -> !(c.constants)) collected
+
+let thresholds_incl_mul2 = ResettableLazy.map (fun c -> !(c.constants_incl_mul2)) collected
+
+type sorted = {
+  constants: Z.t array;
+  upper: Z.t array;
+  lower: Z.t array;
+}
+
+let sorted_of_collected (c: collected) = {
+  constants = Array.of_list (Thresholds.elements !(c.constants));
+  upper = Array.of_list (Thresholds.elements !(c.upper));
+  lower = Array.of_list (Thresholds.elements !(c.lower));
+}
+
+let program_sorted = ResettableLazy.map sorted_of_collected collected
+
+(** Per-function thresholds by function name, collected on the first widening in the function.
+    Unlike the whole-program thresholds, they are kept across incremental runs for unchanged functions. *)
+let function_sorted: (string, sorted) Hashtbl.t = Hashtbl.create 113
+
+let fundec_sorted (fd: fundec) =
+  match Hashtbl.find_option function_sorted fd.svar.vname with
+  | Some sorted -> sorted
+  | None ->
+    let c = create_collected () in
+    ignore (visitCilFunction (new extractThresholdsVisitor c) fd);
+    let sorted = sorted_of_collected c in
+    Hashtbl.replace function_sorted fd.svar.vname sorted;
+    sorted
+
+type marshal = (string, sorted) Hashtbl.t
+
+let marshal () = Hashtbl.copy function_sorted
+
+let unmarshal (m: marshal) =
+  Hashtbl.clear function_sorted;
+  Hashtbl.iter (Hashtbl.replace function_sorted) m
+
+let retain_functions keep =
+  Hashtbl.filteri_inplace (fun name _ -> keep name) function_sorted
+
+let function_scope = ResettableLazy.from_fun (fun () -> GobConfig.get_string "ana.int.interval_threshold_widening_scope" = "function")
+
+let current_sorted () =
+  match !Node.current_node with
+  | Some node when ResettableLazy.force function_scope -> fundec_sorted (Node.find_fundec node)
+  | _ -> ResettableLazy.force program_sorted
+
+(* index of the first threshold in [ts] greater than [z] (or equal if [incl]) *)
+let search ~incl (ts: Z.t array) z =
+  let rec search lo hi =
+    if lo >= hi then
+      lo
+    else
+      let mid = lo + (hi - lo) / 2 in
+      let c = Z.compare ts.(mid) z in
+      if c > 0 || (incl && c = 0) then search lo mid else search (mid + 1) hi
+  in
+  search 0 (Array.length ts)
+
+let find_geq ts z =
+  let i = search ~incl:true ts z in
+  if i < Array.length ts then Some ts.(i) else None
 
-let thresholds = ResettableLazy.map fst widening_thresholds
+let find_leq ts z =
+  let i = search ~incl:false ts z in
+  if i > 0 then Some ts.(i - 1) else None
 
-let thresholds_incl_mul2 = ResettableLazy.map snd widening_thresholds
+let mem ts z =
+  match find_geq ts z with
+  | Some t -> Z.equal t z
+  | None -> false
 
 module EH = BatHashtbl.Make (CilType.Exp)
 
@@ -146,11 +224,12 @@ let exps = ResettableLazy.from_fun (fun () ->
   )
 
 let reset_lazy () =
-  ResettableLazy.reset widening_thresholds;
-  ResettableLazy.reset conditional_widening_thresholds;
+  ResettableLazy.reset collected;
   ResettableLazy.reset exps;
   ResettableLazy.reset thresholds;
   ResettableLazy.reset thresholds_incl_mul2;
   ResettableLazy.reset upper_thresholds;
   ResettableLazy.reset lower_thresholds;
   ResettableLazy.reset octagon_thresholds;
+  ResettableLazy.reset program_sorted;
+  ResettableLazy.reset function_scope
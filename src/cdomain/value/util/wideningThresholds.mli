@@ -9,4 +9,32 @@ val exps: GoblintCil.exp list ResettableLazy.t
 val reset_lazy : unit -> unit
 val upper_thresholds : Thresholds.t ResettableLazy.t
 val lower_thresholds : Thresholds.t ResettableLazy.t
-val octagon_thresholds : Thresholds.t ResettableLazy.t
\ No newline at end of file
+val octagon_thresholds : Thresholds.t ResettableLazy.t
+(** Thresholds as sorted arrays for lookup by binary search. *)
+type sorted = {
+  constants: Z.t array;
+  upper: Z.t array;
+  lower: Z.t array;
+}
+
+(** Thresholds of the function of the current node if [ana.int.interval_threshold_widening_scope] is [function], otherwise of the whole program. *)
+val current_sorted : unit -> sorted
+
+(** Per-function thresholds for incremental data. *)
+type marshal
+
+val marshal : unit -> marshal
+
+(** Replace per-function thresholds with ones from incremental data. *)
+val unmarshal : marshal -> unit
+
+(** Keep only per-function thresholds of functions, whose names satisfy the predicate, e.g. unchanged ones. *)
+val retain_functions : (string -> bool) -> unit
+
+(** Least threshold greater than or equal to the given one. *)
+val find_geq : Z.t array -> Z.t -> Z.t option
+
+(** Greatest threshold less than or equal to the given one. *)
+val find_leq : Z.t array -> Z.t -> Z.t option
+
+val mem : Z.t array -> Z.t -> bool
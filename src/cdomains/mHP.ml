@@ -50,23 +50,33 @@ include Printable.SimplePretty (
   end
   )
 
-(** Can it be excluded that the thread tid2 is running at a program point where  *)
-(*  thread tid1 has created the threads in created1 *)
-let definitely_not_started (current, created) other =
-  if (not (TID.must_be_ancestor current other)) then
+(** Ancestor relations of thread ids, which may be replaced by cached ones (see {!Index}). *)
+type ancestors = {
+  must_be_ancestor: TID.t -> TID.t -> bool;
+  may_be_ancestor: TID.t -> TID.t -> bool;
+}
+
+let tid_ancestors = {must_be_ancestor = TID.must_be_ancestor; may_be_ancestor = TID.may_be_ancestor}
+
+let definitely_not_started' anc (current, created) other =
+  if (not (anc.must_be_ancestor current other)) then
     false
   else
-    let ident_or_may_be_created creator = TID.equal creator other || TID.may_be_ancestor creator other in
+    let ident_or_may_be_created creator = TID.equal creator other || anc.may_be_ancestor creator other in
     if ConcDomain.ThreadSet.is_top created then
       false
     else
       not @@ ConcDomain.ThreadSet.exists (ident_or_may_be_created) created
 
-let exists_definitely_not_started_in_joined (current,created) other_joined =
+(** Can it be excluded that the thread tid2 is running at a program point where  *)
+(*  thread tid1 has created the threads in created1 *)
+let definitely_not_started = definitely_not_started' tid_ancestors
+
+let exists_definitely_not_started_in_joined anc (current,created) other_joined =
   if ConcDomain.ThreadSet.is_top other_joined then
     false
   else
-    ConcDomain.ThreadSet.exists (definitely_not_started (current,created)) other_joined
+    ConcDomain.ThreadSet.exists (definitely_not_started' anc (current,created)) other_joined
 
 (** Must the thread with thread id other be already joined  *)
 let must_be_joined other joined =
@@ -75,20 +85,128 @@ let must_be_joined other joined =
   else
     ConcDomain.ThreadSet.mem other joined
 
-(** May two program points with respective MHP information happen in parallel *)
-let may_happen_in_parallel one two =
+let may_happen_in_parallel' anc one two =
   let {tid=tid; created=created; must_joined=must_joined} = one in
   let {tid=tid2; created=created2; must_joined=must_joined2} = two in
   match tid,tid2 with
   | `Lifted tid, `Lifted tid2 ->
     if (TID.is_unique tid) && (TID.equal tid tid2) then
       false
-    else if definitely_not_started (tid,created) tid2 || definitely_not_started (tid2,created2) tid then
+    else if definitely_not_started' anc (tid,created) tid2 || definitely_not_started' anc (tid2,created2) tid then
       false
     else if must_be_joined tid2 must_joined || must_be_joined tid must_joined2 then
       false
-    else if exists_definitely_not_started_in_joined (tid,created) must_joined2 || exists_definitely_not_started_in_joined (tid2,created2) must_joined then
+    else if exists_definitely_not_started_in_joined anc (tid,created) must_joined2 || exists_definitely_not_started_in_joined anc (tid2,created2) must_joined then
       false
     else
       true
   | _ -> true
+
+(** May two program points with respective MHP information happen in parallel *)
+let may_happen_in_parallel = may_happen_in_parallel' tid_ancestors
+
+(** Index for repeated MHP queries during race checking.
+    Thread ids and MHP information are numbered on first use, and ancestor relations and MHP results are cached per pair of numbers.
+    Race checking asks for the same few pairs for many access pairs. *)
+module Index =
+struct
+  module TH = Hashtbl.Make (TID)
+  module H = Hashtbl.Make (struct
+      type nonrec t = t
+      let equal = equal
+      let hash = hash
+    end)
+
+  let tids: int TH.t = TH.create 113
+  let mhps: int H.t = H.create 113
+  let must_ancestors: (int * int, bool) Hashtbl.t = Hashtbl.create 113
+  let may_ancestors: (int * int, bool) Hashtbl.t = Hashtbl.create 113
+  let parallel: (int * int, bool) Hashtbl.t = Hashtbl.create 113
+
+  let number find add length x =
+    match find x with
+    | Some i -> i
+    | None ->
+      let i = length () in
+      add x i;
+      i
+
+  let tid = number (TH.find_opt tids) (TH.replace tids) (fun () -> TH.length tids)
+  let mhp = number (H.find_opt mhps) (H.replace mhps) (fun () -> H.length mhps)
+
+  let cached tbl f k =
+    match Hashtbl.find_opt tbl k with
+    | Some b -> b
+    | None ->
+      let b = f () in
+      Hashtbl.replace tbl k b;
+      b
+
+  let ancestors = {
+    must_be_ancestor = (fun t t' -> cached must_ancestors (fun () -> TID.must_be_ancestor t t') (tid t, tid t'));
+    may_be_ancestor = (fun t t' -> cached may_ancestors (fun () -> TID.may_be_ancestor t t') (tid t, tid t'));
+  }
+
+  (** Numbers of MHP information, which have not been reset since. Compared physically, so unmarshaled numbers are never current. *)
+  let generation = ref (ref ())
+
+  (** [may_happen_in_parallel] of MHP information [one] and [two] with numbers [i] and [j]. *)
+  let may_happen_in_parallel_numbered (i, one) (j, two) =
+    let k = if i <= j then (i, j) else (j, i) in (* symmetric *)
+    cached parallel (fun () -> may_happen_in_parallel' ancestors one two) k
+
+  let may_happen_in_parallel one two =
+    may_happen_in_parallel_numbered (mhp one, one) (mhp two, two)
+
+  let reset () =
+    generation := ref ();
+    TH.clear tids;
+    H.clear mhps;
+    Hashtbl.clear must_ancestors;
+    Hashtbl.clear may_ancestors;
+    Hashtbl.clear parallel
+end
+
+(** MHP information with its number in {!Index}, assigned when an access is created.
+    Race checking then looks up results by number, without hashing the MHP information for each pair of accesses.
+    Equality, ordering and hashing only depend on the MHP information. *)
+module Numbered =
+struct
+  include Printable.Std
+
+  let name () = "mhp"
+
+  type mhp = t
+  type t = {
+    mhp: mhp;
+    number: int;
+    generation: unit ref; (** {!Index.generation} of [number]. *)
+  }
+
+  let of_mhp mhp = {mhp; number = Index.mhp mhp; generation = !Index.generation}
+
+  let current ask = of_mhp (current ask)
+
+  let number x =
+    if x.generation == !Index.generation then
+      x.number
+    else
+      Index.mhp x.mhp (* numbered before reset or unmarshaled *)
+
+  let equal x y = equal x.mhp y.mhp
+  let compare x y = compare x.mhp y.mhp
+  let hash x = hash x.mhp
+  let relift x = {x with mhp = relift x.mhp}
+
+  let pretty () x = pretty () x.mhp
+
+  include Printable.SimplePretty (
+    struct
+      type nonrec t = t
+      let pretty = pretty
+    end
+    )
+
+  let may_happen_in_parallel x y =
+    Index.may_happen_in_parallel_numbered (number x, x.mhp) (number y, y.mhp)
+end
@@ -34,6 +34,10 @@ let global_initialization = ref false
 (** Whether currently in postsolver evaluations (e.g. verify, warn) *)
 let postsolving = ref false
 
+(** Called by solvers between right-hand side evaluations, e.g. to handle server requests during solving.
+    May raise [Sys.Break] to abort the analysis. *)
+let poll: (unit -> unit) ref = ref ignore
+
 (* None if verification is disabled, Some true if verification succeeded, Some false if verification failed *)
 let verified : bool option ref = ref None
 
@@ -117,6 +117,32 @@ let computeSCCs (module Cfg: CfgBidir) nodes =
 
 let computeSCCs x = Timing.wrap "computeSCCs" (computeSCCs x)
 
+(** Loop heads of [scc] in [Cfg]: its entry nodes and the targets of back edges of a DFS from them within [scc].
+    Unlike entry nodes, these also include the heads of loops nested in [scc]. *)
+let scc_loop_heads (module Cfg: CfgForward) (scc: SCC.t): unit NH.t =
+  let heads = NH.create 3 in
+  let visited = NH.create (NH.length scc.nodes) in
+  let on_path = NH.create 13 in
+  let rec dfs node =
+    NH.replace visited node ();
+    NH.replace on_path node ();
+    List.iter (fun (_, next_node) ->
+        if NH.mem scc.nodes next_node then (
+          if NH.mem on_path next_node then
+            NH.replace heads next_node ()
+          else if not (NH.mem visited next_node) then
+            dfs next_node
+        )
+      ) (Cfg.next node);
+    NH.remove on_path node
+  in
+  NH.iter (fun node _ ->
+      NH.replace heads node ();
+      if not (NH.mem visited node) then
+        dfs node
+    ) scc.prev;
+  heads
+
 let rec pretty_edges () = function
   | [] -> Pretty.dprintf ""
   | [_,x] -> Edge.pretty_plain () x
@@ -611,6 +637,55 @@ let fprint_hash_dot cfg  =
   close_out out
 
 
+(** Dense representation of the CFG given by [cfgF] and [cfgB].
+    Nodes are numbered contiguously per function and their successors and predecessors are stored in arrays,
+    such that lookups index by [sid] or [vid] instead of hashing structural nodes. *)
+let dense_cfg (file: file) cfgF cfgB: cfg * cfg =
+  let module IntH = Cilfacade.IntH in
+  let max_sid = H.fold (fun n _ acc -> match n with Statement s -> max acc s.sid | _ -> acc) cfgB (-1) in
+  let max_sid = H.fold (fun n _ acc -> match n with Statement s -> max acc s.sid | _ -> acc) cfgF max_sid in
+  let stmt_index = Array.make (max_sid + 1) (-1) in
+  let other_stmt_index = IntH.create 13 in (* pseudo returns have negative sids *)
+  let entry_index = IntH.create 113 in
+  let return_index = IntH.create 113 in
+  let index = function
+    | Statement s when s.sid >= 0 -> if s.sid <= max_sid then stmt_index.(s.sid) else -1
+    | Statement s -> Option.value ~default:(-1) (IntH.find_opt other_stmt_index s.sid)
+    | FunctionEntry fd -> Option.value ~default:(-1) (IntH.find_opt entry_index fd.svar.vid)
+    | Function fd -> Option.value ~default:(-1) (IntH.find_opt return_index fd.svar.vid)
+  in
+  let count = ref 0 in
+  let number n =
+    if index n < 0 && (H.mem cfgF n || H.mem cfgB n) then (
+      let i = !count in
+      incr count;
+      match n with
+      | Statement s when s.sid >= 0 -> stmt_index.(s.sid) <- i
+      | Statement s -> IntH.replace other_stmt_index s.sid i
+      | FunctionEntry fd -> IntH.replace entry_index fd.svar.vid i
+      | Function fd -> IntH.replace return_index fd.svar.vid i
+    )
+  in
+  iterGlobals file (function
+      | GFun (fd, _) ->
+        number (FunctionEntry fd);
+        List.iter (fun s -> number (Statement s)) fd.sallstmts;
+        number (Function fd)
+      | _ -> ()
+    );
+  (* remaining nodes, e.g. pseudo returns *)
+  H.iter (fun n _ -> number n) cfgF;
+  H.iter (fun n _ -> number n) cfgB;
+  let next = Array.make !count [] in
+  let prev = Array.make !count [] in
+  H.iter (fun n es -> next.(index n) <- es) cfgF;
+  H.iter (fun n es -> prev.(index n) <- es) cfgB;
+  let find a n =
+    let i = index n in
+    if i < 0 then [] else a.(i)
+  in
+  (find next, find prev)
+
 let getCFG (file: file) : cfg * cfg * _ =
   let cfgF, cfgB, skippedByEdge = createCFG file in
   let cfgF, cfgB, skippedByEdge =
@@ -620,7 +695,8 @@ let getCFG (file: file) : cfg * cfg * _ =
       (cfgF, cfgB, skippedByEdge)
   in
   if get_bool "justcfg" then fprint_hash_dot cfgB;
-  (fun n -> H.find_default cfgF n []), (fun n -> H.find_default cfgB n []), (fun u e v -> CfgEdgeH.find skippedByEdge (u, e, v))
+  let next, prev = Timing.wrap "dense cfg" (dense_cfg file cfgF) cfgB in
+  next, prev, (fun u e v -> CfgEdgeH.find skippedByEdge (u, e, v))
 
 let compute_cfg file =
   let cfgF, cfgB, skippedByEdge = getCFG file in
@@ -700,21 +776,53 @@ let getGlobalInits (file: file) : edges  =
         Hashtbl.add inits (assign lval) ()
       else if not (Hashtbl.mem inits (assign (any_index lval))) then
         Hashtbl.add inits (assign (any_index lval)) ()
+    | CompoundInit (typ, lst) when fast_global_inits && array_length typ > List.length lst ->
+      (* Explicit elements are assigned individually, all implicit ones at once instead of folding over all of them. *)
+      List.iter (fun (offs, init) -> doInit (addOffsetLval offs lval) loc init is_zero) lst;
+      begin match Cil.unrollType typ with
+        | TArray (t, _, _) -> doZeroInit (any_index_lval lval) loc t
+        | _ -> assert false
+      end
+    | CompoundInit (TComp (ci, _), lst) when fast_global_inits && ci.cstruct && List.for_all (function (Field (_, NoOffset), _) -> true | _ -> false) lst ->
+      (* Implicit fields are zero-initialized without makeZeroInit, which expands arrays element-wise. *)
+      List.iter (fun f ->
+          match List.find_opt (function (Field (f', _), _) -> CilType.Fieldinfo.equal f f' | _ -> false) lst with
+          | Some (offs, init) -> doInit (addOffsetLval offs lval) loc init is_zero
+          | None when f.fname <> missingFieldName -> doZeroInit (addOffsetLval (Field (f, NoOffset)) lval) loc f.ftype
+          | None -> ()
+        ) ci.cfields
     | CompoundInit (typ, lst) ->
       let ntyp = match Cil.unrollType typ, lst with
         | TArray(t, None, attr), [] -> TArray(t, Some zero, attr) (* set initializer type to t[0] for flexible array members of structs that are intialized with {} *)
         | _, _ -> typ
       in
       ignore (foldLeftCompound ~implicit:true ~doinit:initoffs ~ct:ntyp ~initl:lst ~acc:lval)
+  (* Like [doInit] with [makeZeroInit], but with fast_global_inits arrays are not expanded element-wise, since all elements are assigned at once anyway.
+     Large zero-initialized buffers would otherwise be expanded into one initializer per element. *)
+  and doZeroInit lval loc typ =
+    match Cil.unrollType typ with
+    | TArray (t, _, _) when fast_global_inits && array_length typ > 0 ->
+      doZeroInit (any_index_lval lval) loc t
+    | TComp (ci, _) when fast_global_inits && ci.cstruct ->
+      List.iter (fun f ->
+          if f.fname <> missingFieldName then (* like makeZeroInit *)
+            doZeroInit (addOffsetLval (Field (f, NoOffset)) lval) loc f.ftype
+        ) ci.cfields
+    | _ ->
+      doInit lval loc (makeZeroInit typ) true
+  and array_length typ =
+    match Cil.unrollType typ with
+    | TArray (_, len, _) -> (try lenOfArray len with LenOfArray -> 0) (* flexible array members are initialized as t[0] *)
+    | _ -> 0
+  and any_index_lval lval =
+    addOffsetLval (Index (Lazy.force Cilfacade.any_index_exp, NoOffset)) lval
   in
   let f glob =
     match glob with
     | GVar ({vtype=vtype; _} as v, init, loc) -> begin
-        let init, is_zero = match init.init with
-          | None -> makeZeroInit vtype, true
-          | Some x -> x, false
-        in
-        doInit (var v) loc init is_zero
+        match init.init with
+        | None -> doZeroInit (var v) loc vtype
+        | Some init -> doInit (var v) loc init false
       end
     | _ -> ()
   in
@@ -752,9 +752,8 @@ module LocSet = Hashtbl.Make(CilType.Location)
  * they are being called in. *)
 let funs_with_upjumping_gotos: unit LocSet.t FunLocH.t = FunLocH.create 13
 
-let reset_lazy ?(keepupjumpinggotos=false) () =
-  StmtH.clear pseudo_return_to_fun;
-  if not keepupjumpinggotos then FunLocH.clear funs_with_upjumping_gotos;
+(** Reset the lazy maps of {!current_file}, but not the tables filled during CFG construction. *)
+let reset_lazy_maps () =
   ResettableLazy.reset stmt_fundecs;
   ResettableLazy.reset varinfo_fundecs;
   ResettableLazy.reset name_fundecs;
@@ -762,6 +761,12 @@ let reset_lazy ?(keepupjumpinggotos=false) () =
   ResettableLazy.reset original_names;
   ResettableLazy.reset stmt_sids
 
+(** [keep_maps] keeps the lazy maps, which only depend on the unchanged [current_file]. *)
+let reset_lazy ?(keepupjumpinggotos=false) ?(keep_maps=false) () =
+  StmtH.clear pseudo_return_to_fun;
+  if not keepupjumpinggotos then FunLocH.clear funs_with_upjumping_gotos;
+  if not keep_maps then reset_lazy_maps ()
+
 
 let stmt_pretty_short () x =
   match x.skind with
@@ -147,15 +147,54 @@ struct
   } [@@deriving eq, ord, hash, yojson]
 end
 
+(** Unrendered message, identified by its format string and the documents of its arguments.
+    Used to deduplicate messages before rendering their text. *)
+module Unrendered =
+struct
+  type t = {
+    tags: Tags.t;
+    severity: Severity.t;
+    template: string; (** Format string of the (group) message. *)
+    pieces: (Pretty.doc * Location.t option) list; (** Documents of the message and its group pieces. *)
+    context: ControlSpecC.t option;
+  }
+
+  let equal_piece (doc1, loc1) (doc2, loc2) =
+    Option.equal Location.equal loc1 loc2 && doc1 = doc2 (* documents are plain data *)
+
+  let equal x y =
+    Tags.equal x.tags y.tags && Severity.equal x.severity y.severity && String.equal x.template y.template && Option.equal ControlSpecC.equal x.context y.context && List.equal equal_piece x.pieces y.pieces
+
+  let hash_piece (doc, loc) =
+    31 * Hashtbl.hash_param 32 128 doc + Hashtbl.hash (Option.map Location.hash loc)
+
+  let hash x =
+    let h = 31 * Tags.hash x.tags + Severity.hash x.severity in
+    let h = 31 * h + Hashtbl.hash x.template in
+    let h = 31 * h + Hashtbl.hash (Option.map ControlSpecC.hash x.context) in
+    List.fold_left (fun h piece -> 31 * h + hash_piece piece) h x.pieces
+end
+
 module Table =
 struct
   module MH = Hashtbl.Make (Message)
+  module UH = Hashtbl.Make (Unrendered)
 
   let messages_table = MH.create 113 (* messages without order for quick mem lookup *)
   let messages_list = ref [] (* messages with reverse order (for cons efficiency) *)
 
+  let unrendered_table: int ref UH.t = UH.create 113 (* already rendered messages with their number of suppressed duplicates *)
+  let duplicates = ref 0 (* total number of suppressed duplicates *)
+
   let mem = MH.mem messages_table
 
+  (** Forget all messages. *)
+  let clear () =
+    MH.clear messages_table;
+    messages_list := [];
+    UH.clear unrendered_table;
+    duplicates := 0
+
   let add_hook: (Message.t -> unit) ref = ref (fun _ -> ())
 
   let add m =
@@ -250,6 +289,16 @@ let add m =
     Table.add m
   )
 
+(** Add a message, which is only rendered if it is not a duplicate of an earlier unrendered message. *)
+let add_unrendered (u: Unrendered.t) render =
+  match Table.UH.find_opt Table.unrendered_table u with
+  | Some suppressed ->
+    incr suppressed;
+    incr Table.duplicates
+  | None ->
+    Table.UH.replace Table.unrendered_table u (ref 0);
+    add (render ())
+
 let final_table: unit Table.MH.t = Table.MH.create 13
 
 let add_final m =
@@ -267,7 +316,9 @@ let finalize () =
   |> List.iter (fun m ->
       print m;
       Table.add m
-    )
+    );
+  if !Table.duplicates > 0 then
+    Logs.debug "Suppressed %d duplicate messages before rendering" !Table.duplicates
 
 let current_context: ControlSpecC.t option ref = ref None
 
@@ -280,12 +331,16 @@ let msg_context () =
 let msg severity ?loc ?(tags=[]) ?(category=Category.Unknown) fmt =
   if !AnalysisState.should_warn && Severity.should_warn severity && (Category.should_warn category || Tags.should_warn tags) then (
     let finish doc =
-      let text = GobPretty.show doc in
+      let tags = Category category :: tags in
       let loc = match loc with
         | Some node -> Some node
         | None -> Option.map (fun node -> Location.Node node) !Node0.current_node
       in
-      add {tags = Category category :: tags; severity; multipiece = Single {loc; text; context = msg_context ()}}
+      let context = msg_context () in
+      add_unrendered {tags; severity; template = string_of_format fmt; pieces = [(doc, loc)]; context} (fun () ->
+          let text = GobPretty.show doc in
+          {tags; severity; multipiece = Single {loc; text; context}}
+        )
     in
     Pretty.gprintf finish fmt
   )
@@ -295,8 +350,11 @@ let msg severity ?loc ?(tags=[]) ?(category=Category.Unknown) fmt =
 let msg_noloc severity ?(tags=[]) ?(category=Category.Unknown) fmt =
   if !AnalysisState.should_warn && Severity.should_warn severity && (Category.should_warn category || Tags.should_warn tags) then (
     let finish doc =
-      let text = GobPretty.show doc in
-      add {tags = Category category :: tags; severity; multipiece = Single {loc = None; text; context = None}}
+      let tags = Category category :: tags in
+      add_unrendered {tags; severity; template = string_of_format fmt; pieces = [(doc, None)]; context = None} (fun () ->
+          let text = GobPretty.show doc in
+          {tags; severity; multipiece = Single {loc = None; text; context = None}}
+        )
     in
     Pretty.gprintf finish fmt
   )
@@ -306,12 +364,15 @@ let msg_noloc severity ?(tags=[]) ?(category=Category.Unknown) fmt =
 let msg_group severity ?loc ?(tags=[]) ?(category=Category.Unknown) fmt =
   if !AnalysisState.should_warn && Severity.should_warn severity && (Category.should_warn category || Tags.should_warn tags) then (
     let finish doc msgs =
-      let group_text = GobPretty.show doc in
-      let piece_of_msg (doc, loc) =
-        let text = GobPretty.show doc in
-        Piece.{loc; text; context = None}
-      in
-      add {tags = Category category :: tags; severity; multipiece = Group {group_text; group_loc = loc; pieces = List.map piece_of_msg msgs}}
+      let tags = Category category :: tags in
+      add_unrendered {tags; severity; template = string_of_format fmt; pieces = (doc, loc) :: msgs; context = None} (fun () ->
+          let group_text = GobPretty.show doc in
+          let piece_of_msg (doc, loc) =
+            let text = GobPretty.show doc in
+            Piece.{loc; text; context = None}
+          in
+          {tags; severity; multipiece = Group {group_text; group_loc = loc; pieces = List.map piece_of_msg msgs}}
+        )
     in
     Pretty.gprintf finish fmt
   )
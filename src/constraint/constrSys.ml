@@ -74,7 +74,6 @@ module type GenericEqIncrSolverBase =
   sig
     type marshal
 
-    val copy_marshal: marshal -> marshal
     val relift_marshal: marshal -> marshal
 
     (** The hash-map that is the first component of [solve xs vs] is a local solution for interesting variables [vs],
@@ -115,7 +114,6 @@ module type GenericGlobSolver =
   sig
     type marshal
 
-    val copy_marshal: marshal -> marshal
     val relift_marshal: marshal -> marshal
 
     (** The hash-map that is the first component of [solve xs vs] is a local solution for interesting variables [vs],
@@ -260,7 +258,6 @@ module GlobSolverFromEqSolver (Sol:GenericEqIncrSolverBase)
 
       type marshal = Sol'.marshal
 
-      let copy_marshal = Sol'.copy_marshal
       let relift_marshal = Sol'.relift_marshal
 
       let solve ls gs l old_data =
@@ -0,0 +1,613 @@
+(** Set domains backed by compressed bitmaps of interned elements. *)
+
+(** Persistent sparse bitmap of non-negative integers.
+
+    Only non-zero machine words are stored, in a pair of arrays sorted by word index,
+    so sparse and clustered sets of dense ids stay small and set operations are linear merges over words. *)
+module Bitmap:
+sig
+  type t
+  val empty: t
+  val is_empty: t -> bool
+  val singleton: int -> t
+  val mem: int -> t -> bool
+  val add: int -> t -> t
+  val remove: int -> t -> t
+  val union: t -> t -> t
+  val inter: t -> t -> t
+  val diff: t -> t -> t
+  val subset: t -> t -> bool
+  val disjoint: t -> t -> bool
+  val cardinal: t -> int
+  val fold: (int -> 'a -> 'a) -> t -> 'a -> 'a (** In increasing order. *)
+  val iter: (int -> unit) -> t -> unit
+  val exists: (int -> bool) -> t -> bool
+  val for_all: (int -> bool) -> t -> bool
+  val filter: (int -> bool) -> t -> t
+  val partition: (int -> bool) -> t -> t * t
+  val of_list: int list -> t
+  val min_elt: t -> int (** @raise Not_found if empty. *)
+  val max_elt: t -> int (** @raise Not_found if empty. *)
+  val equal: t -> t -> bool
+  val compare: t -> t -> int
+  val hash: t -> int
+end =
+struct
+  (** Invariant: [idx] is strictly increasing and [bits] contains no zero words. *)
+  type t = {
+    idx: int array; (** Word indices. *)
+    bits: int array; (** Words. *)
+  }
+
+  let word_size = Sys.int_size
+
+  let empty = {idx = [||]; bits = [||]}
+  let is_empty a = Array.length a.idx = 0
+
+  let singleton i = {idx = [|i / word_size|]; bits = [|1 lsl (i mod word_size)|]}
+
+  (** Position of word index [w] in [a.idx] or [-1]. *)
+  let find_word w a =
+    let rec bsearch lo hi =
+      if lo >= hi then
+        -1
+      else (
+        let mid = (lo + hi) / 2 in
+        let w' = a.idx.(mid) in
+        if w' = w then mid
+        else if w' < w then bsearch (mid + 1) hi
+        else bsearch lo mid
+      )
+    in
+    bsearch 0 (Array.length a.idx)
+
+  let mem i a =
+    match find_word (i / word_size) a with
+    | -1 -> false
+    | k -> a.bits.(k) land (1 lsl (i mod word_size)) <> 0
+
+  (** Merge words of [a] and [b] by word index.
+      Words only in [a] ([b]) are kept if [left] ([right]).
+      Words in both are combined with [f]. Resulting zero words are dropped. *)
+  let merge ~left ~right f a b =
+    let n1 = Array.length a.idx in
+    let n2 = Array.length b.idx in
+    let idx = Array.make (n1 + n2) 0 in
+    let bits = Array.make (n1 + n2) 0 in
+    let push k w x =
+      if x <> 0 then (
+        idx.(k) <- w;
+        bits.(k) <- x;
+        k + 1
+      )
+      else
+        k
+    in
+    let rec go i j k =
+      if i < n1 && j < n2 then (
+        let wi = a.idx.(i) in
+        let wj = b.idx.(j) in
+        if wi < wj then
+          go (i + 1) j (if left then push k wi a.bits.(i) else k)
+        else if wi > wj then
+          go i (j + 1) (if right then push k wj b.bits.(j) else k)
+        else
+          go (i + 1) (j + 1) (push k wi (f a.bits.(i) b.bits.(j)))
+      )
+      else if i < n1 then
+        go (i + 1) j (if left then push k a.idx.(i) a.bits.(i) else k)
+      else if j < n2 then
+        go i (j + 1) (if right then push k b.idx.(j) b.bits.(j) else k)
+      else
+        k
+    in
+    let k = go 0 0 0 in
+    if k = 0 then
+      empty
+    else
+      {idx = Array.sub idx 0 k; bits = Array.sub bits 0 k}
+
+  let union a b =
+    if a == b || is_empty b then a
+    else if is_empty a then b
+    else merge ~left:true ~right:true (lor) a b
+
+  let inter a b =
+    if a == b then a
+    else if is_empty a || is_empty b then empty
+    else merge ~left:false ~right:false (land) a b
+
+  let diff a b =
+    if is_empty a || is_empty b then a
+    else merge ~left:true ~right:false (fun x y -> x land lnot y) a b
+
+  let add i a = if mem i a then a else union a (singleton i)
+  let remove i a = if mem i a then diff a (singleton i) else a
+
+  let subset a b =
+    let n1 = Array.length a.idx in
+    let n2 = Array.length b.idx in
+    let rec go i j =
+      if i >= n1 then
+        true
+      else if j >= n2 then
+        false
+      else (
+        let wi = a.idx.(i) in
+        let wj = b.idx.(j) in
+        if wi < wj then false
+        else if wi > wj then go i (j + 1)
+        else a.bits.(i) land lnot b.bits.(j) = 0 && go (i + 1) (j + 1)
+      )
+    in
+    a == b || go 0 0
+
+  let disjoint a b =
+    let n1 = Array.length a.idx in
+    let n2 = Array.length b.idx in
+    let rec go i j =
+      if i >= n1 || j >= n2 then
+        true
+      else (
+        let wi = a.idx.(i) in
+        let wj = b.idx.(j) in
+        if wi < wj then go (i + 1) j
+        else if wi > wj then go i (j + 1)
+        else a.bits.(i) land b.bits.(j) = 0 && go (i + 1) (j + 1)
+      )
+    in
+    go 0 0
+
+  let rec popcount x =
+    if x = 0 then 0 else 1 + popcount (x land (x - 1))
+
+  let cardinal a = Array.fold_left (fun acc x -> acc + popcount x) 0 a.bits
+
+  let fold f a acc =
+    let acc = ref acc in
+    Array.iteri (fun k x ->
+        let base = a.idx.(k) * word_size in
+        let x = ref x in
+        let i = ref 0 in
+        while !x <> 0 do
+          if !x land 1 <> 0 then
+            acc := f (base + !i) !acc;
+          x := !x lsr 1;
+          incr i
+        done
+      ) a.bits;
+    !acc
+
+  let iter f a = fold (fun i () -> f i) a ()
+  let exists p a = fold (fun i acc -> acc || p i) a false
+  let for_all p a = fold (fun i acc -> acc && p i) a true
+
+  (** Word of the bits [i] of word [x] at word index [w] which satisfy [p]. *)
+  let filter_word p w x =
+    let base = w * word_size in
+    let r = ref 0 in
+    let x = ref x in
+    let i = ref 0 in
+    while !x <> 0 do
+      if !x land 1 <> 0 && p (base + !i) then
+        r := !r lor (1 lsl !i);
+      x := !x lsr 1;
+      incr i
+    done;
+    !r
+
+  (** Bitmap of the first [k] entries of [idx] and [bits]. *)
+  let sub idx bits k =
+    if k = 0 then
+      empty
+    else
+      {idx = Array.sub idx 0 k; bits = Array.sub bits 0 k}
+
+  let filter p a =
+    let n = Array.length a.idx in
+    let idx = Array.make n 0 in
+    let bits = Array.make n 0 in
+    let k = ref 0 in
+    let changed = ref false in
+    for j = 0 to n - 1 do
+      let x = filter_word p a.idx.(j) a.bits.(j) in
+      if x <> a.bits.(j) then
+        changed := true;
+      if x <> 0 then (
+        idx.(!k) <- a.idx.(j);
+        bits.(!k) <- x;
+        incr k
+      )
+    done;
+    if !changed then sub idx bits !k else a
+
+  let partition p a =
+    let n = Array.length a.idx in
+    let idx1 = Array.make n 0 in
+    let bits1 = Array.make n 0 in
+    let idx2 = Array.make n 0 in
+    let bits2 = Array.make n 0 in
+    let k1 = ref 0 in
+    let k2 = ref 0 in
+    for j = 0 to n - 1 do
+      let w = a.idx.(j) in
+      let x1 = filter_word p w a.bits.(j) in
+      let x2 = a.bits.(j) land lnot x1 in
+      if x1 <> 0 then (
+        idx1.(!k1) <- w;
+        bits1.(!k1) <- x1;
+        incr k1
+      );
+      if x2 <> 0 then (
+        idx2.(!k2) <- w;
+        bits2.(!k2) <- x2;
+        incr k2
+      )
+    done;
+    (sub idx1 bits1 !k1, sub idx2 bits2 !k2)
+
+  let of_list is =
+    match List.sort_uniq Int.compare is with
+    | [] -> empty
+    | is ->
+      let n = List.length is in
+      let idx = Array.make n 0 in
+      let bits = Array.make n 0 in
+      let k = List.fold_left (fun k i ->
+          let w = i / word_size in
+          let b = 1 lsl (i mod word_size) in
+          if k > 0 && idx.(k - 1) = w then (
+            bits.(k - 1) <- bits.(k - 1) lor b;
+            k
+          )
+          else (
+            idx.(k) <- w;
+            bits.(k) <- b;
+            k + 1
+          )
+        ) 0 is
+      in
+      sub idx bits k
+
+  let min_elt a =
+    if is_empty a then
+      raise Not_found
+    else (
+      let x = a.bits.(0) in
+      let rec lowest i = if x land (1 lsl i) <> 0 then i else lowest (i + 1) in
+      a.idx.(0) * word_size + lowest 0
+    )
+
+  let max_elt a =
+    let n = Array.length a.idx in
+    if n = 0 then
+      raise Not_found
+    else (
+      let x = a.bits.(n - 1) in
+      let rec highest i = if x land (1 lsl i) <> 0 then i else highest (i - 1) in
+      a.idx.(n - 1) * word_size + highest (word_size - 1)
+    )
+
+  let equal a b = a == b || (a.idx = b.idx && a.bits = b.bits)
+
+  let compare a b =
+    if a == b then
+      0
+    else (
+      let c = Stdlib.compare a.idx b.idx in
+      if c <> 0 then c else Stdlib.compare a.bits b.bits
+    )
+
+  let hash a =
+    let h = Array.fold_left (fun h w -> 31 * h + w) 0 a.idx in
+    Array.fold_left (fun h x -> 31 * h + x) h a.bits
+end
+
+
+(** Functions resetting all interning tables. *)
+let resets: (unit -> unit) list ref = ref []
+
+(** Reset all interning tables.
+    Only allowed when no bitmaps of earlier analyses are used anymore. *)
+let reset () = List.iter (fun f -> f ()) !resets
+
+(** Interning of elements to dense integer ids.
+
+    Ids are only meaningful within one process, so they must not be marshaled. *)
+module Intern (E: Printable.S) =
+struct
+  module EH = Hashtbl.Make (E)
+
+  let ids: int EH.t = EH.create 113
+  let elts: E.t BatDynArray.t = BatDynArray.create ()
+
+  let () = resets := (fun () -> EH.clear ids; BatDynArray.clear elts) :: !resets
+
+  let id e =
+    match EH.find_opt ids e with
+    | Some i -> i
+    | None ->
+      let i = BatDynArray.length elts in
+      BatDynArray.add elts e;
+      EH.replace ids e i;
+      i
+
+  let find_id_opt e = EH.find_opt ids e
+
+  let elt i = BatDynArray.get elts i
+end
+
+
+
+
+(** Elements which may be stored in a bitmap instead of the underlying set domain. *)
+module type Atomic =
+sig
+  type elt
+
+  val enabled: unit -> bool
+  (** Whether bitmaps are used at all.
+      Only checked when creating sets, all other operations follow the representation of their arguments. *)
+
+  val is_atomic: elt -> bool
+  (** Whether an element is atomic,
+      i.e. it is alone in its bucket of the underlying set domain and therefore never needs to be joined with another element. *)
+
+  val atom_of: elt -> elt option
+  (** Atomic element, whose bucket is compared with the bucket of a non-atomic element by meet of the underlying set domain. *)
+
+  val may_be_equal: elt -> elt -> bool
+  (** Whether meet of the underlying set domain keeps a non-atomic element and its [atom_of], because they may be equal. *)
+end
+
+(** Set of elements [E.t], where atomic elements (according to [A]) are interned and stored in a {!Bitmap},
+    and all other elements are stored in [B].
+    If bitmaps are disabled, sets are just sets of [B] and all operations are directly delegated to [B].
+
+    Lattice operations on atomic elements are set operations on bitmaps.
+    Only meet relates atomic elements to other elements of [B], see {!Atomic.may_be_equal}. *)
+module Split (E: Printable.S) (B: SetDomain.S with type elt = E.t) (A: Atomic with type elt = E.t): SetDomain.S with type elt = E.t =
+struct
+  include Printable.Std
+
+  type elt = E.t
+
+  module I = Intern (E)
+
+  (** Invariant: [atoms] contains exactly the atomic elements, [rest] none. *)
+  type split = {
+    atoms: Bitmap.t;
+    rest: B.t;
+  }
+
+  type t =
+    | Plain of B.t (** Bitmaps disabled. *)
+    | Split of split
+
+  let name () = "Bitset (" ^ B.name () ^ ")"
+
+  let of_rest rest = Split {atoms = Bitmap.empty; rest}
+
+  (** Move atomic elements into [B] for delegation. *)
+  let to_b = function
+    | Plain b -> b
+    | Split x -> Bitmap.fold (fun i acc -> B.add (I.elt i) acc) x.atoms x.rest
+
+  (** Inverse of [to_b]. *)
+  let split_of_b b =
+    if B.exists A.is_atomic b then
+      let ids = B.fold (fun e acc -> if A.is_atomic e then I.id e :: acc else acc) b [] in
+      {atoms = Bitmap.of_list ids; rest = B.filter (fun e -> not (A.is_atomic e)) b}
+    else
+      {atoms = Bitmap.empty; rest = b}
+
+  let to_split = function
+    | Plain b -> split_of_b b
+    | Split x -> x
+
+  (** Set of [B] in the enabled representation. *)
+  let make b =
+    if A.enabled () then
+      Split (split_of_b b)
+    else
+      Plain b
+
+  (** Same as [make] for [b] without atomic elements. *)
+  let make_rest b =
+    if A.enabled () then
+      of_rest b
+    else
+      Plain b
+
+  (** Apply [plain] if both are [Plain], otherwise [split] after converting both to [Split]. *)
+  let binary plain split x y =
+    match x, y with
+    | Plain a, Plain b -> plain a b
+    | _, _ -> split (to_split x) (to_split y)
+
+  (* Representations are only mixed if the configuration changes between server analyses.
+     Then sets of different representations are unequal, which only causes re-evaluation, but keeps [equal], [compare] and [hash] consistent. *)
+  let equal x y =
+    x == y || match x, y with
+    | Plain a, Plain b -> B.equal a b
+    | Split x, Split y -> Bitmap.equal x.atoms y.atoms && B.equal x.rest y.rest
+    | _, _ -> false
+
+  (* Order of atomic elements depends on interning order, which is deterministic for a run. *)
+  let compare x y =
+    if x == y then
+      0
+    else
+      match x, y with
+      | Plain a, Plain b -> B.compare a b
+      | Split x, Split y ->
+        let c = Bitmap.compare x.atoms y.atoms in
+        if c <> 0 then c else B.compare x.rest y.rest
+      | Plain _, Split _ -> -1
+      | Split _, Plain _ -> 1
+
+  let hash = function
+    | Plain b -> B.hash b
+    | Split x -> 13 * Bitmap.hash x.atoms + B.hash x.rest
+
+  let relift = function
+    | Plain b -> Plain (B.relift b)
+    | Split x -> Split {x with rest = B.relift x.rest}
+
+  let bot () = make_rest (B.bot ())
+  let is_bot = function
+    | Plain b -> B.is_bot b
+    | Split x -> Bitmap.is_empty x.atoms && B.is_bot x.rest
+  let top () = make_rest (B.top ())
+  let is_top = function
+    | Plain b -> B.is_top b
+    | Split x -> B.is_top x.rest
+
+  let empty () = make_rest (B.empty ())
+  let is_empty = function
+    | Plain b -> B.is_empty b
+    | Split x -> Bitmap.is_empty x.atoms && B.is_empty x.rest
+  let cardinal = function
+    | Plain b -> B.cardinal b
+    | Split x -> Bitmap.cardinal x.atoms + B.cardinal x.rest
+
+  let mem e = function
+    | Plain b -> B.mem e b
+    | Split x when A.is_atomic e ->
+      begin match I.find_id_opt e with
+        | Some i -> Bitmap.mem i x.atoms
+        | None -> false
+      end
+    | Split x -> B.mem e x.rest
+  let add e = function
+    | Plain b -> Plain (B.add e b)
+    | Split x when A.is_atomic e -> Split {x with atoms = Bitmap.add (I.id e) x.atoms}
+    | Split x -> Split {x with rest = B.add e x.rest}
+  let singleton e =
+    if not (A.enabled ()) then
+      Plain (B.singleton e)
+    else if A.is_atomic e then
+      Split {atoms = Bitmap.singleton (I.id e); rest = B.empty ()}
+    else
+      of_rest (B.singleton e)
+  let remove e = function
+    | Plain b -> Plain (B.remove e b)
+    | Split x when A.is_atomic e ->
+      begin match I.find_id_opt e with
+        | Some i -> Split {x with atoms = Bitmap.remove i x.atoms}
+        | None -> Split x
+      end
+    | Split x -> Split {x with rest = B.remove e x.rest}
+
+  let fold f x acc =
+    match x with
+    | Plain b -> B.fold f b acc
+    | Split x -> B.fold f x.rest (Bitmap.fold (fun i acc -> f (I.elt i) acc) x.atoms acc)
+  let iter f = function
+    | Plain b -> B.iter f b
+    | Split x ->
+      Bitmap.iter (fun i -> f (I.elt i)) x.atoms;
+      B.iter f x.rest
+  let exists p = function
+    | Plain b -> B.exists p b
+    | Split x -> Bitmap.exists (fun i -> p (I.elt i)) x.atoms || B.exists p x.rest
+  let for_all p = function
+    | Plain b -> B.for_all p b
+    | Split x -> Bitmap.for_all (fun i -> p (I.elt i)) x.atoms && B.for_all p x.rest
+  let filter p = function
+    | Plain b -> Plain (B.filter p b)
+    | Split x -> Split {atoms = Bitmap.filter (fun i -> p (I.elt i)) x.atoms; rest = B.filter p x.rest}
+  let partition p = function
+    | Plain b ->
+      let (b1, b2) = B.partition p b in
+      (Plain b1, Plain b2)
+    | Split x ->
+      let (rest1, rest2) = B.partition p x.rest in
+      let (atoms1, atoms2) = Bitmap.partition (fun i -> p (I.elt i)) x.atoms in
+      (Split {atoms = atoms1; rest = rest1}, Split {atoms = atoms2; rest = rest2})
+
+  let elements = function
+    | Plain b -> B.elements b
+    | x -> fold List.cons x [] (* no intermediate per-part lists *)
+  let of_list es = make (B.of_list es)
+  let map f = function
+    | Plain b -> Plain (B.map f b)
+    | x ->
+      let (ids, rest) = fold (fun e (ids, rest) ->
+          let e = f e in
+          if A.is_atomic e then
+            (I.id e :: ids, rest)
+          else
+            (ids, B.add e rest)
+        ) x ([], B.empty ())
+      in
+      Split {atoms = Bitmap.of_list ids; rest}
+
+  (** Smallest (or largest if [cmp] is reversed) element like in [B], not by id. *)
+  let extremum cmp b_extremum = function
+    | Plain b -> b_extremum b
+    | Split x ->
+      let atom = Bitmap.fold (fun i acc ->
+          let e = I.elt i in
+          match acc with
+          | Some e' when cmp e' e <= 0 -> acc
+          | _ -> Some e
+        ) x.atoms None
+      in
+      match atom with
+      | None -> b_extremum x.rest
+      | Some e when B.is_empty x.rest -> e
+      | Some e ->
+        let e' = b_extremum x.rest in
+        if cmp e e' <= 0 then e else e'
+  let choose = extremum E.compare B.choose
+  let min_elt = extremum E.compare B.min_elt
+  let max_elt = extremum (fun e1 e2 -> E.compare e2 e1) B.max_elt
+
+  let leq x y = x == y || binary B.leq (fun x y -> Bitmap.subset x.atoms y.atoms && B.leq x.rest y.rest) x y
+  let join x y =
+    if x == y then
+      x
+    else
+      binary (fun a b -> Plain (B.join a b)) (fun x y -> Split {atoms = Bitmap.union x.atoms y.atoms; rest = B.join x.rest y.rest}) x y
+  let widen = binary (fun a b -> Plain (B.widen a b)) (fun x y -> Split {atoms = Bitmap.union x.atoms y.atoms; rest = B.widen x.rest y.rest})
+
+  (** Add elements of [rest], which meet of [B] keeps because they may be equal to their atomic element in [atoms], to [acc]. *)
+  let meet_atoms_rest atoms rest acc =
+    B.fold (fun e ((atoms', rest') as acc) ->
+        match A.atom_of e with
+        | Some a when A.may_be_equal a e ->
+          begin match I.find_id_opt a with
+            | Some i when Bitmap.mem i atoms -> (Bitmap.add i atoms', B.add e rest')
+            | _ -> acc
+          end
+        | _ -> acc
+      ) rest acc
+
+  let meet = binary (fun a b -> Plain (B.meet a b)) (fun x y ->
+      let acc = (Bitmap.inter x.atoms y.atoms, B.meet x.rest y.rest) in
+      let acc = meet_atoms_rest x.atoms y.rest acc in
+      let (atoms, rest) = meet_atoms_rest y.atoms x.rest acc in
+      Split {atoms; rest}
+    )
+  (* Narrow of [B] only relates elements of the same bucket. *)
+  let narrow = binary (fun a b -> Plain (B.narrow a b)) (fun x y -> Split {atoms = Bitmap.inter x.atoms y.atoms; rest = B.narrow x.rest y.rest})
+
+  let union = binary (fun a b -> Plain (B.union a b)) (fun x y -> Split {atoms = Bitmap.union x.atoms y.atoms; rest = B.union x.rest y.rest})
+  let inter = meet
+  let diff = binary (fun a b -> Plain (B.diff a b)) (fun x y -> Split {atoms = Bitmap.diff x.atoms y.atoms; rest = B.diff x.rest y.rest})
+  let subset = leq
+  let disjoint x y = is_empty (inter x y)
+
+  let pretty_diff () (x, y) = B.pretty_diff () (to_b x, to_b y)
+
+  (* Print in the order of [B], independent of interning order. *)
+  include SetDomain.Print (E) (
+    struct
+      type nonrec t = t
+      type nonrec elt = elt
+      let elements x = B.elements (to_b x)
+      let iter f x = B.iter f (to_b x)
+    end
+    )
+end
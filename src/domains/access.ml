@@ -114,9 +114,11 @@ module TSH = Hashtbl.Make (CilType.Typsig)
 let typeVar  = TSH.create 101
 let typeIncl = TSH.create 101
 let collect_direct_arithmetic = ref false
+let intern_enabled = ref false
 
 let init (f:file) =
   collect_direct_arithmetic := get_bool "ana.race.direct-arithmetic";
+  intern_enabled := get_bool "ana.race.intern";
   let visited_vars = Hashtbl.create 100 in
   let add tsh t v =
     let rec add' ts =
@@ -440,6 +442,47 @@ struct
     accs |> elements |> List.map (fun {A.conf; _} -> conf) |> (BatList.max ~cmp:Int.compare)
 end
 
+(** Interning of accesses, such that equal accesses and equal analysis-specific payloads (e.g. lock sets) are shared in memory.
+    Race checking keeps all accesses until the end, and the same payload occurs at many nodes. *)
+module Intern =
+struct
+  module AW = Weak.Make (A)
+  module PW = Weak.Make (MCPAccess.A)
+
+  let accs = AW.create 1024
+  let payloads = PW.create 1024
+  let hits = ref 0
+  let misses = ref 0
+
+  let intern (acc: A.t) =
+    match AW.find_opt accs acc with
+    | Some acc' ->
+      incr hits;
+      acc'
+    | None ->
+      incr misses;
+      let acc = {acc with A.acc = PW.merge payloads acc.A.acc} in
+      AW.add accs acc;
+      acc
+
+  let pretty_stats () () =
+    Pretty.dprintf "interned accesses: %d (%d payloads, %d words), hits: %d, misses: %d"
+      (AW.count accs) (PW.count payloads) (PW.fold (fun p n -> n + Obj.reachable_words (Obj.repr p)) payloads 0) !hits !misses
+
+  let reset () =
+    AW.clear accs;
+    PW.clear payloads;
+    hits := 0;
+    misses := 0
+end
+
+(** Intern access, if enabled by [ana.race.intern]. *)
+let intern acc =
+  if !intern_enabled then
+    Intern.intern acc
+  else
+    acc
+
 
 (** Check if two accesses may race. *)
 let may_race A.{kind; acc; _} A.{kind=kind2; acc=acc2; _} =
@@ -629,7 +672,37 @@ let print_accesses memo grouped_accs =
         M.msg_group Success ?loc:group_loc ~category:Race "Memory location %a (safe)" Memo.pretty memo (msgs safe_accs)
     )
 
+(** [warn_global] calls deferred by parallel race checking: counters, access sets and memo. *)
+let deferred_warn_globals: (int ref * int ref * int ref * WarnAccs.t * Memo.t) list ref = ref []
+
 let warn_global ~safe ~vulnerable ~unsafe warn_accs memo =
-  let grouped_accs = group_may_race warn_accs in (* do expensive component finding only once *)
-  incr_summary ~safe ~vulnerable ~unsafe grouped_accs;
-  print_accesses memo grouped_accs
+  if jobs () > 1 then
+    deferred_warn_globals := (safe, vulnerable, unsafe, warn_accs, memo) :: !deferred_warn_globals
+  else (
+    let grouped_accs = group_may_race warn_accs in (* do expensive component finding only once *)
+    incr_summary ~safe ~vulnerable ~unsafe grouped_accs;
+    print_accesses memo grouped_accs
+  )
+
+module AH = Hashtbl.Make (A)
+
+(** Finish deferred [warn_global] calls.
+    Components are found in parallel worker processes and returned as indices into all accesses of the memo, because accesses are large to marshal.
+    Summaries and race messages are then produced in the original order of memos.
+    They are emitted after all other [warn_global] messages, so the output only matches a sequential run with [warn.deterministic]. *)
+let finish_warn_globals () =
+  let deferred = List.rev !deferred_warn_globals in
+  deferred_warn_globals := [];
+  let group_indices (_, _, _, warn_accs, _) =
+    let index = AH.create 17 in
+    AS.iter (fun acc -> AH.replace index acc (AH.length index)) (WarnAccs.union_all warn_accs); (* in order of AS.elements *)
+    group_may_race warn_accs
+    |> List.map (fun comp -> List.map (AH.find index) (AS.elements comp))
+  in
+  let grouped_indices = Timing.wrap "race components" (ProcessPool.fork_map ~jobs:(jobs ()) group_indices) deferred in
+  List.iter2 (fun (safe, vulnerable, unsafe, warn_accs, memo) comps ->
+      let accs = Array.of_list (AS.elements (WarnAccs.union_all warn_accs)) in
+      let grouped_accs = List.map (fun comp -> AS.of_list (List.map (Array.get accs) comp)) comps in
+      incr_summary ~safe ~vulnerable ~unsafe grouped_accs;
+      print_accesses memo grouped_accs
+    ) deferred grouped_indices
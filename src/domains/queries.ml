@@ -123,6 +123,7 @@ type _ t =
   | InvariantGlobal: Obj.t -> Invariant.t t (** Argument must be of corresponding [Spec.V.t]. *)
   | WarnGlobal: Obj.t -> Unit.t t (** Argument must be of corresponding [Spec.V.t]. *)
   | IterSysVars: VarQuery.t * Obj.t VarQuery.f -> Unit.t t (** [iter_vars] for [Constraints.FromSpec]. [Obj.t] represents [Spec.V.t]. *)
+  | IterComponents: (string -> Obj.t -> unit) -> Unit.t t (** Iterate over analysis names and their components of the local state, for [dbg.memory-attribution]. [Obj.t] represents [Spec.D.t]. *)
   | MayAccessed: AccessDomain.EventSet.t t
   | MayBeTainted: AD.t t
   | MayBeModifiedSinceSetjmp: JmpBufDomain.BufferEntry.t -> VS.t t
@@ -198,6 +199,7 @@ struct
     | InvariantGlobal _ -> (module Invariant)
     | WarnGlobal _ -> (module Unit)
     | IterSysVars _ -> (module Unit)
+    | IterComponents _ -> (module Unit)
     | MayAccessed -> (module AccessDomain.EventSet)
     | MayBeTainted -> (module AD)
     | MayBeModifiedSinceSetjmp _ -> (module VS)
@@ -272,6 +274,7 @@ struct
     | InvariantGlobal _ -> Invariant.top ()
     | WarnGlobal _ -> Unit.top ()
     | IterSysVars _ -> Unit.top ()
+    | IterComponents _ -> Unit.top ()
     | MayAccessed -> AccessDomain.EventSet.top ()
     | MayBeTainted -> AD.top ()
     | MayBeModifiedSinceSetjmp _ -> VS.top ()
@@ -355,6 +358,7 @@ struct
     | Any (MustProtectingLocks _) -> 61
     | Any (GhostVarAvailable _) -> 62
     | Any InvariantGlobalNodes -> 63
+    | Any (IterComponents _) -> 64
 
   let rec compare a b =
     let r = Stdlib.compare (order a) (order b) in
@@ -462,6 +466,7 @@ struct
     (* IterSysVars:                                                                    *)
     (*   - argument is a function and functions cannot be compared in any meaningful way. *)
     (*   - doesn't matter because IterSysVars is always queried from outside of the analysis, so MCP's query caching is not done for it. *)
+    (* IterComponents: same as IterSysVars. *)
     (* only argumentless queries should remain *)
     | _ -> 0
 
@@ -511,6 +516,7 @@ struct
     | Any (Invariant i) -> Pretty.dprintf "Invariant _"
     | Any (WarnGlobal vi) -> Pretty.dprintf "WarnGlobal _"
     | Any (IterSysVars _) -> Pretty.dprintf "IterSysVars _"
+    | Any (IterComponents _) -> Pretty.dprintf "IterComponents _"
     | Any (InvariantGlobal i) -> Pretty.dprintf "InvariantGlobal _"
     | Any (YamlEntryGlobal (i, task)) -> Pretty.dprintf "YamlEntryGlobal _"
     | Any (MutexType (v,o)) ->  Pretty.dprintf "MutexType _"
@@ -530,7 +536,7 @@ struct
 end
 
 let to_value_domain_ask (ask: ask) =
-  let eval_int e = ask.f (EvalInt e) in
+  let eval_int = VDQ.memo_eval_int (fun e -> ask.f (EvalInt e)) in
   let may_point_to e = ask.f (MayPointTo e) in
   let is_multiple v = ask.f (IsMultiple v) in
   { VDQ.eval_int; may_point_to; is_multiple }
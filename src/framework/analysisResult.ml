@@ -141,8 +141,10 @@ struct
         BatPrintf.fprintf f "</result></run>\n";
         BatPrintf.fprintf f "%!"
       in
-      if get_bool "g2html" then
-        BatFile.with_temporary_out ~mode:[`create;`text;`delete_on_exit] write_file
+      if get_bool "g2html" then (
+        if not (get_bool "exp.g2html_native") then (* native HTML is written from the table by Control *)
+          BatFile.with_temporary_out ~mode:[`create;`text;`delete_on_exit] write_file
+      )
       else
         let f = BatIO.output_channel out in
         write_file f (get_string "outfile")
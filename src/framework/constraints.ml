@@ -15,6 +15,33 @@ sig
 end
 
 
+(** State of the memoization of combines in {!FromSpec}, which must not outlive an analysis:
+    keys contain hashconsed states, whose tags change on relifting loaded incremental data. *)
+module CombineMemoState =
+struct
+  let size = ref 0
+  let hits = ref 0
+  let misses = ref 0
+  let uncacheable = ref 0
+
+  (** Clears the table of the current {!FromSpec}. *)
+  let clear_table = ref (fun () -> ())
+
+  (** Called before solving, i.e. also before relifting. *)
+  let init () =
+    size := get_int "ana.opt.combine-memo";
+    hits := 0;
+    misses := 0;
+    uncacheable := 0;
+    !clear_table ()
+
+  let finalize () =
+    if !hits + !misses > 0 then
+      Logs.debug "Combine memo: %d hits, %d misses (%d uncacheable), hit rate %.1f%%" !hits !misses !uncacheable (100. *. float_of_int !hits /. float_of_int (!hits + !misses));
+    !clear_table ()
+end
+
+
 (** The main point of this file---generating a [GlobConstrSys] from a [Spec]. *)
 module FromSpec (S:Spec) (Cfg:CfgBackward) (I: Increment)
   : sig
@@ -177,8 +204,68 @@ struct
     let d = S.branch man e tv in (* Force transfer function to be evaluated before dereferencing in common_join argument. *)
     common_join man d !r !spawns
 
+  (** Memoization of combines in {!tf_normal_call} by call edge, caller state, callee context and callee return state.
+      Only combines, which neither read globals or the context nor have effects, are memoized.
+      Disabled while warning, because cached combines would not repeat their messages. *)
+  module CombineMemo =
+  struct
+    module Key =
+    struct
+      type t = {
+        prev_node: Node.t;
+        node: Node.t;
+        f: CilType.Fundec.t;
+        fc: S.C.t option;
+        cd: D.t;
+        fd: D.t;
+      } [@@deriving eq, hash]
+    end
+
+    module KH = Hashtbl.Make (Key)
+
+    let table: D.t KH.t = KH.create 113
+    let () = CombineMemoState.clear_table := (fun () -> KH.clear table)
+
+    (** [memo man key combine] returns the memoized result for [key] or calls [combine] with a [man], which tracks accesses preventing memoization. *)
+    let memo man (key: Key.t) combine =
+      let open CombineMemoState in
+      if !size <= 0 || !AnalysisState.should_warn then
+        combine man
+      else (
+        match KH.find_option table key with
+        | Some r ->
+          incr hits;
+          r
+        | None ->
+          incr misses;
+          let cacheable = ref true in
+          let impure f = cacheable := false; f in
+          let man' =
+            { man with
+              global = (fun g -> impure man.global g)
+            ; sideg = (fun g d -> impure man.sideg g d)
+            ; spawn = (fun ?multiple lval f args -> impure man.spawn ?multiple lval f args)
+            ; split = (fun d es -> impure man.split d es)
+            ; context = (fun () -> impure man.context ())
+            ; control_context = (fun () -> impure man.control_context ())
+            ; emit = (fun ev -> impure man.emit ev)
+            }
+          in
+          let r = combine man' in
+          if !cacheable then (
+            if KH.length table >= !size then
+              KH.clear table; (* simple bound, hot edges are quickly cached again *)
+            KH.replace table key r
+          )
+          else
+            incr uncacheable;
+          r
+      )
+  end
+
   let tf_normal_call man lv e (f:fundec) args getl sidel getg sideg =
     let combine (cd, fc, fd) =
+      CombineMemo.memo man {CombineMemo.Key.prev_node = man.prev_node; node = man.node; f; fc; cd; fd} @@ fun man ->
       if M.tracing then M.traceli "combine" "local: %a" S.D.pretty cd;
       if M.tracing then M.trace "combine" "function: %a" S.D.pretty fd;
       let rec cd_man =
@@ -25,6 +25,7 @@ let spec_module: (module Spec) Lazy.t = lazy (
     (val
       (module MCP.MCP2 : Spec)
       |> lift (get_int "ana.context.gas_value" >= 0) (ContextGasLifter.get_gas_lifter ())
+      |> lift (get_int "ana.context.limit" >= 0) (module ContextLimitLifter.Lifter)
       |> lift true (module WidenContextLifterSide) (* option checked in functor *)
       (* hashcons before witness to reduce duplicates, because witness re-uses contexts in domain and requires tag for PathSensitive3 *)
       |> lift (get_bool "ana.opt.hashcons" || arg_enabled) (module HashconsContextLifter)
@@ -356,6 +357,59 @@ struct
       GHT.iter print_one glob
     in
 
+    (* Estimate heap words held by the solution with [Obj.reachable_words].
+       Words shared between values are counted for each of them, so the numbers overapproximate. *)
+    let memory_attribution lh gh file =
+      let add tbl k words = Hashtbl.modify_def 0 k ((+) words) tbl in
+      let locals = Hashtbl.create 13 in
+      let functions = Hashtbl.create 113 in
+      LHT.iter (fun ((node, _) as lvar) local ->
+          let fname = (Node.find_fundec node).svar.vname in
+          Query.ask_local gh lvar local (Queries.IterComponents (fun name d ->
+              let words = Obj.reachable_words d in
+              let by_analysis = match Hashtbl.find_option functions fname with
+                | Some by_analysis -> by_analysis
+                | None ->
+                  let by_analysis = Hashtbl.create 13 in
+                  Hashtbl.replace functions fname by_analysis;
+                  by_analysis
+              in
+              add locals name words;
+              add by_analysis name words
+            ))
+        ) lh;
+      let globals_by_analysis = Hashtbl.create 13 in
+      let globals = GHT.fold (fun g v acc ->
+          let name = EQSys.GVar.show g in
+          let words = Obj.reachable_words (Obj.repr v) in
+          (* globals of analyses are shown with their name as prefix, others (e.g. contexts of functions) are not *)
+          let analysis = match String.split name ~by:":" with
+            | (analysis, _) when Hashtbl.mem MCPRegistry.registered_name analysis -> analysis
+            | _ -> "other"
+            | exception Not_found -> "other"
+          in
+          add globals_by_analysis analysis words;
+          (name, `Int words) :: acc
+        ) gh []
+      in
+      let by_name = List.sort (fun (x, _) (y, _) -> String.compare x y) in
+      let words tbl = `Assoc (by_name (Hashtbl.fold (fun name w acc -> (name, `Int w) :: acc) tbl [])) in
+      let analyses = List.sort_uniq String.compare (List.of_enum (Enum.append (Hashtbl.keys locals) (Hashtbl.keys globals_by_analysis))) in
+      let json = `Assoc [
+          ("analyses", `Assoc (List.map (fun name ->
+               (name, `Assoc [
+                   ("locals", `Int (Hashtbl.find_default locals name 0));
+                   ("globals", `Int (Hashtbl.find_default globals_by_analysis name 0));
+                 ])
+             ) analyses));
+          ("functions", `Assoc (by_name (Hashtbl.fold (fun fname by_analysis acc -> (fname, words by_analysis) :: acc) functions [])));
+          ("globals", `Assoc (by_name globals));
+        ]
+      in
+      Logs.Format.info "Writing memory attribution to %a" Fpath.pp file;
+      Yojson.Safe.to_file (Fpath.to_string file) json
+    in
+
     (* real beginning of the [analyze] function *)
     if get_bool "ana.sv-comp.enabled" then
       Witness.init (module FileCfg); (* TODO: move this out of analyze_loop *)
@@ -366,16 +420,36 @@ struct
     let marshal: Spec.marshal option =
       if get_string "load_run" <> "" then
         Some (Serialize.unmarshal Fpath.(v (get_string "load_run") / "spec_marshal"))
-      else if Serialize.results_exist () && get_bool "incremental.load" then
-        Some (Serialize.Cache.(get_data AnalysisData))
+      else if Serialize.results_exist () && get_bool "incremental.load" then (
+        match Serialize.Cache.(get_opt_data AnalysisData, get_opt_data SolverData) with
+        | Some marshal, _ -> Some marshal
+        | None, Some _ -> failwith "Incremental data contains solver data without analysis data, cannot resume from it."
+        | None, None -> None
+      )
       else
         None
     in
 
     (* Some happen in init, so enable this temporarily (if required by option). *)
     AnalysisState.should_warn := PostSolverArg.should_warn;
+    begin match Inc.increment with
+      | None ->
+        BitsetDomain.reset (); (* no values with interned elements from earlier analyses *)
+        WideningThresholds.retain_functions (fun _ -> false)
+      | Some {server; changes; _} ->
+        if not server then
+          Option.may WideningThresholds.unmarshal Serialize.Cache.(get_opt_data Thresholds);
+        let unchanged = List.filter_map (fun (u: CompareCIL.unchanged_global) -> match u.current.def with
+            | Some (CompareCIL.Fun fd) -> Some fd.svar.vname
+            | _ -> None
+          ) changes.unchanged
+        in
+        let unchanged = Set.of_list unchanged in
+        WideningThresholds.retain_functions (fun name -> Set.mem name unchanged) (* thresholds of changed functions are collected again *)
+    end;
     Spec.init marshal;
     Access.init file;
+    CombineMemoState.init ();
     AnalysisState.should_warn := false;
 
     let test_domain (module D: Lattice.S): unit =
@@ -538,11 +612,12 @@ struct
             r1 (* return the result of the first run for further options -- maybe better to exit early since compare_runs is its own mode. Only excluded verify below since it's on by default. *)
           | _ -> failwith "Currently only two runs can be compared!";
         ) else (
+          let server = match Inc.increment with Some {server; _} -> server | None -> false in
           let solver_data =
             match Inc.increment with
             | Some {solver_data; server; _} ->
               if server then
-                Some (Slvr.copy_marshal solver_data) (* Copy, so that we can abort and reuse old data unmodified. *)
+                Some solver_data (* Modified in place, but in a transaction below, so that we can abort and reuse old data unmodified. *)
               else if GobConfig.get_bool "ana.opt.hashcons" then
                 Some (Slvr.relift_marshal solver_data)
               else
@@ -551,7 +626,21 @@ struct
           in
           Logs.debug "%s" ("Solving the constraint system with " ^ get_string "solver" ^ ". Solver statistics are shown every " ^ string_of_int (get_int "dbg.solver-stats-interval") ^ "s or by signal " ^ get_string "dbg.solver-signal" ^ ".");
           AnalysisState.should_warn := get_string "warn_at" = "early" || gobview;
-          let (lh, gh), solver_data = Timing.wrap "solving" (Slvr.solve entrystates entrystates_global startvars') solver_data in
+          (* Checkpoints store the analysis data of the current solver state, without its warnings. *)
+          Goblint_solver.SolverCheckpoint.store_analysis_data := (fun () ->
+              let should_warn = !AnalysisState.should_warn in
+              AnalysisState.should_warn := false;
+              Fun.protect ~finally:(fun () -> AnalysisState.should_warn := should_warn) (fun () ->
+                  Serialize.Cache.(update_data AnalysisData (Spec.finalize ()))
+                )
+            );
+          let solve solver_data =
+            if server then
+              Goblint_solver.SolverJournal.transaction (fun () -> Slvr.solve entrystates entrystates_global startvars' solver_data)
+            else
+              Slvr.solve entrystates entrystates_global startvars' solver_data
+          in
+          let (lh, gh), solver_data = Timing.wrap "solving" solve solver_data in
           if GobConfig.get_bool "incremental.save" then
             Serialize.Cache.(update_data SolverData solver_data);
           if save_run_str <> "" then (
@@ -635,6 +724,12 @@ struct
       if get_bool "dump_globs" then
         print_globals gh;
 
+      if get_bool "dbg.memory-attribution" then (
+        let dir = if save_run_str <> "" then Fpath.v save_run_str else Fpath.v "." in (* next to solver_stats.csv *)
+        GobSys.mkdir_or_exists dir;
+        Timing.wrap "memory attribution" (memory_attribution lh gh) Fpath.(dir / "memory.json")
+      );
+
       (* run activated transformations with the analysis result *)
       let active_transformations = get_string_list "trans.activated" in
       if active_transformations <> [] then (
@@ -695,7 +790,7 @@ struct
     in
 
     (* Use "normal" constraint solving *)
-    let timeout_reached () =
+    let abort () =
       M.error "Timeout reached!";
       (* let module S = Generic.SolverStats (EQSys) (LHT) in *)
       (* Can't call Generic.SolverStats...print_stats :(
@@ -703,6 +798,12 @@ struct
          The alternative would be to catch the below Timeout, print_stats and re-raise in each solver (or include it in some functor above them). *)
       raise Timeout.Timeout
     in
+    let timeout_reached () =
+      (* A checkpointing solver aborts after writing a checkpoint at its next safe point, otherwise (or if the timeout signal repeats before that) abort immediately. *)
+      if not (Goblint_solver.SolverCheckpoint.request_abort abort) then
+        abort ()
+    in
+    Goblint_solver.SolverCheckpoint.abort_at (get_int "incremental.checkpoint.abort-after") abort;
     let timeout = get_string "dbg.timeout" |> TimeUtil.seconds_of_duration_string in
     let lh, gh = Timeout.wrap solve_and_postprocess () (float_of_int timeout) timeout_reached in
     let module SpecSysSol: SpecSysSol with module SpecSys = SpecSys =
@@ -750,7 +851,7 @@ struct
         fun _ -> true (* TODO: warn about conflicting options *)
     in
 
-    if get_bool "exp.cfgdot" then
+    if get_bool "exp.cfgdot" || (get_bool "g2html" && not (get_bool "exp.g2html_native")) then
       CfgTools.dead_code_cfg (module FileCfg) liveness;
 
     let warn_global g v =
@@ -762,6 +863,7 @@ struct
         ()
     in
     Timing.wrap "warn_global" (GHT.iter warn_global) gh;
+    Access.finish_warn_globals (); (* race checking deferred with jobs *)
 
     if get_bool "exp.arg.enabled" then (
       let module ArgTool = ArgTools.Make (R) in
@@ -813,6 +915,7 @@ struct
     );
 
     let marshal = Spec.finalize () in
+    CombineMemoState.finalize ();
     (* copied from solve_and_postprocess *)
     let gobview = get_bool "gobview" in
     let save_run = let o = get_string "save_run" in if o = "" then (if gobview then "run" else "") else o in
@@ -821,13 +924,21 @@ struct
     );
     if get_bool "incremental.save" then (
       Serialize.Cache.(update_data AnalysisData marshal);
+      Serialize.Cache.(update_data Thresholds (WideningThresholds.marshal ()));
       if not (get_bool "server.enabled") then
         Serialize.Cache.store_data ()
     );
     if get_string "result" <> "none" then Logs.debug "Generating output: %s" (get_string "result");
 
     Messages.finalize ();
-    Timing.wrap "result output" (Result.output (lazy local_xml) gh make_global_fast_xml) file
+    Timing.wrap "result output" (Result.output (lazy local_xml) gh make_global_fast_xml) file;
+    if get_bool "g2html" && get_bool "exp.g2html_native" then (
+      let module Html = HtmlOutput.Make (LT) in
+      let iter_globals f = GHT.iter (fun k v -> f (EQSys.GVar.show k) (EQSys.G.pretty () v)) gh in
+      Timing.wrap "html output" (fun () ->
+          Html.write (module Cfg) liveness file ~iter:(fun f -> Result.iter f local_xml) ~iter_globals
+        ) ()
+    )
 end
 
 (* This function was originally a part of the [AnalyzeCFG] module, but
@@ -0,0 +1,221 @@
+(** Native HTML output of analysis results, replacing [g2html.jar].
+
+    Pages are generated directly from the result table (also when loaded by [load_run]), without writing and re-parsing XML.
+    Per-file pages (with the pages of their nodes and functions) are generated in parallel by [jobs] worker processes.
+    CFGs are only printed for functions whose file page is generated and rendered to SVG if Graphviz [dot] is available. *)
+
+open Batteries
+open GoblintCil
+
+module NH = Hashtbl.Make (Node)
+
+let escape = XmlUtil.escape
+
+let page_header f ~root title =
+  BatPrintf.fprintf f "<!DOCTYPE html>\n<html>\n<head>\n<meta charset=\"utf-8\">\n<title>%s</title>\n<link rel=\"stylesheet\" href=\"%sstyle.css\">\n</head>\n<body>\n<nav><a href=\"%sindex.html\">index</a> | <a href=\"%sglobals.html\">globals</a> | <a href=\"%swarnings.html\">warnings</a></nav>\n<h1>%s</h1>\n" (escape title) root root root root (escape title)
+
+let page_footer f =
+  BatPrintf.fprintf f "</body>\n</html>\n"
+
+let with_page path ~root title k =
+  File.with_file_out (Fpath.to_string path) (fun f ->
+      page_header f ~root title;
+      k f;
+      page_footer f
+    )
+
+let style = {|body { font-family: sans-serif; }
+pre, .src { font-family: monospace; }
+.src td { padding: 0 0.5em; vertical-align: top; white-space: pre; }
+.src .line { color: gray; text-align: right; }
+.src .dead { background: #ffd8a8; }
+.src .warn { background: #ffe3e3; }
+.src .nodes a { margin-right: 0.3em; }
+.state { border-top: 1px solid #ccc; margin: 0.5em 0; }
+|}
+
+(** Whether Graphviz [dot] is available to render CFGs. *)
+let dot_available = lazy (Sys.command "dot -V > /dev/null 2>&1" = 0)
+
+(** Locations of warnings by file and line. *)
+let warning_lines () =
+  let lines = Hashtbl.create 113 in
+  let add_piece (piece: Messages.Piece.t) =
+    match piece.loc with
+    | Some loc ->
+      let l = Messages.Location.to_cil loc in
+      Hashtbl.add lines (l.file, l.line) piece.text
+    | None -> ()
+  in
+  List.iter (fun (m: Messages.Message.t) ->
+      match m.multipiece with
+      | Single piece -> add_piece piece
+      | Group {pieces; _} -> List.iter add_piece pieces
+    ) !Messages.Table.messages_list;
+  lines
+
+module Make (Range: Printable.S) =
+struct
+  (** Result nodes of one source file. *)
+  type file = {
+    id: int;
+    path: string;
+    funs: fundec list;
+    nodes: (int * Node.t) list; (** Line and node. *)
+  }
+
+  let node_page dir n v =
+    let loc = UpdateCil.getLoc n in
+    let fd = Node.find_fundec n in
+    with_page Fpath.(dir / "nodes" / (Node.show_id n ^ ".html")) ~root:"../" (Node.show_id n) (fun f ->
+        BatPrintf.fprintf f "<p>%s in function %s</p>\n" (escape (CilType.Location.show loc)) (escape fd.svar.vname);
+        BatPrintf.fprintf f "<pre class=\"state\">%s</pre>\n" (escape (Pretty.sprint ~width:80 (Range.pretty () v)))
+      )
+
+  let fun_page (module Cfg: MyCFG.CfgBidir) live dir (file: file) (fd: fundec) =
+    let cfg_dir = Fpath.(dir / "cfgs" / string_of_int file.id) in
+    GobSys.mkdir_or_exists cfg_dir;
+    let dot = Fpath.(cfg_dir / (fd.svar.vname ^ ".dot")) in
+    File.with_file_out (Fpath.to_string dot) (fun oc ->
+        let ppf = Format.formatter_of_output oc in
+        CfgTools.fprint_fundec_html_dot (module Cfg) live fd ppf;
+        Format.pp_print_flush ppf ()
+      );
+    let svg =
+      if Lazy.force dot_available then (
+        let svg = Fpath.(cfg_dir / (fd.svar.vname ^ ".svg")) in
+        let command = Filename.quote_command "dot" ["-Tsvg"; "-o"; Fpath.to_string svg; Fpath.to_string dot] in
+        if Sys.command command = 0 then
+          Some (File.with_file_in (Fpath.to_string svg) IO.read_all)
+        else (
+          Logs.warn "CFG rendering failed! Command: %s" command;
+          None
+        )
+      )
+      else
+        None
+    in
+    with_page Fpath.(cfg_dir / (fd.svar.vname ^ ".html")) ~root:"../../" fd.svar.vname (fun f ->
+        BatPrintf.fprintf f "<script>function show_info(id) { window.location = '../../nodes/' + id + '.html'; }</script>\n";
+        BatPrintf.fprintf f "<p><a href=\"../../files/%d.html\">%s</a> | <a href=\"%s.dot\">dot</a></p>\n" file.id (escape file.path) (escape fd.svar.vname);
+        match svg with
+        | Some svg ->
+          let start = try String.find svg "<svg" with Not_found -> 0 in (* inline without XML prolog, such that show_info links work *)
+          BatPrintf.fprintf f "%s\n" (String.tail svg start)
+        | None ->
+          BatPrintf.fprintf f "<p>Graphviz is not available, see the <a href=\"%s.dot\">dot</a> file.</p>\n" (escape fd.svar.vname)
+      )
+
+  let file_page live warnings dir (file: file) =
+    let by_line = Hashtbl.create 113 in
+    List.iter (fun (line, n) -> Hashtbl.add by_line line n) file.nodes;
+    let max_line = List.fold_left (fun acc (line, _) -> max acc line) 0 file.nodes in
+    let source =
+      try Array.of_enum (File.lines_of file.path)
+      with Sys_error _ -> Array.make max_line "" (* show only lines with results *)
+    in
+    with_page Fpath.(dir / "files" / (string_of_int file.id ^ ".html")) ~root:"../" file.path (fun f ->
+        BatPrintf.fprintf f "<h2>Functions</h2>\n<ul>\n";
+        List.iter (fun (fd: fundec) ->
+            BatPrintf.fprintf f "<li><a href=\"../cfgs/%d/%s.html\">%s</a></li>\n" file.id (escape fd.svar.vname) (escape fd.svar.vname)
+          ) file.funs;
+        BatPrintf.fprintf f "</ul>\n<h2>Source</h2>\n<table class=\"src\">\n";
+        Array.iteri (fun i text ->
+            let line = i + 1 in
+            let nodes = List.rev (Hashtbl.find_all by_line line) in
+            let warns = Hashtbl.find_all warnings (file.path, line) in
+            let cls =
+              if warns <> [] then " class=\"warn\""
+              else if nodes <> [] && not (List.exists live nodes) then " class=\"dead\""
+              else ""
+            in
+            BatPrintf.fprintf f "<tr id=\"l%d\"%s><td class=\"line\">%d</td><td class=\"nodes\">" line cls line;
+            List.iter (fun n -> BatPrintf.fprintf f "<a href=\"../nodes/%s.html\">%s</a>" (Node.show_id n) (Node.show_id n)) nodes;
+            BatPrintf.fprintf f "</td><td title=\"%s\">%s</td></tr>\n" (escape (String.concat "\n" warns)) (escape text)
+          ) source;
+        BatPrintf.fprintf f "</table>\n"
+      )
+
+  let index_page dir files =
+    with_page Fpath.(dir / "index.html") ~root:"" "Goblint results" (fun f ->
+        BatPrintf.fprintf f "<p>%s</p>\n<h2>Files</h2>\n<ul>\n" (escape GobSys.command_line);
+        List.iter (fun file ->
+            BatPrintf.fprintf f "<li><a href=\"files/%d.html\">%s</a></li>\n" file.id (escape file.path)
+          ) files;
+        BatPrintf.fprintf f "</ul>\n<h2>Statistics</h2>\n<pre>";
+        let timing = Format.asprintf "%t" (fun ppf -> Timing.Default.print ppf) in
+        BatPrintf.fprintf f "%s</pre>\n" (escape timing)
+      )
+
+  let globals_page dir iter_globals =
+    with_page Fpath.(dir / "globals.html") ~root:"" "Globals" (fun f ->
+        iter_globals (fun name doc ->
+            BatPrintf.fprintf f "<h3>%s</h3>\n<pre class=\"state\">%s</pre>\n" (escape name) (escape (Pretty.sprint ~width:80 doc))
+          )
+      )
+
+  let warnings_page dir files =
+    let ids = Hashtbl.create 13 in
+    List.iter (fun file -> Hashtbl.replace ids file.path file.id) files;
+    (* link to the line on the file page, like g2html *)
+    let link (piece: Messages.Piece.t) =
+      let open GobOption.Syntax in
+      let* loc = piece.loc in
+      let l = Messages.Location.to_cil loc in
+      let+ id = Hashtbl.find_option ids l.file in
+      Printf.sprintf "<a href=\"files/%d.html#l%d\">%s:%d</a>" id l.line (escape l.file) l.line
+    in
+    with_page Fpath.(dir / "warnings.html") ~root:"" "Warnings" (fun f ->
+        BatPrintf.fprintf f "<ul>\n";
+        List.iter (fun (m: Messages.Message.t) ->
+            let text = Format.asprintf "%t" (fun ppf -> Messages.print ~ppf m) in
+            let pieces = match m.multipiece with
+              | Single piece -> [piece]
+              | Group {pieces; _} -> pieces
+            in
+            BatPrintf.fprintf f "<li><pre>%s</pre>%s</li>\n" (escape text) (String.concat " " (List.filter_map link pieces))
+          ) (List.rev !Messages.Table.messages_list);
+        BatPrintf.fprintf f "</ul>\n"
+      )
+
+  (** Write HTML pages for the results iterated by [iter] and [iter_globals] into directory [outfile]. *)
+  let write cfg live (ast: Cil.file) ~(iter: (Node.t -> Range.t -> unit) -> unit) ~(iter_globals: (string -> Pretty.doc -> unit) -> unit) =
+    let dir = Fpath.v (GobConfig.get_string "outfile") in
+    Logs.info "Writing HTML to %a" Fpath.pp dir;
+    GobSys.mkdir_or_exists dir;
+    List.iter (fun sub -> GobSys.mkdir_or_exists Fpath.(dir / sub)) ["files"; "nodes"; "cfgs"];
+    File.with_file_out Fpath.(to_string (dir / "style.css")) (fun f -> IO.nwrite f style);
+
+    (* group nodes and functions by source file *)
+    let values = NH.create 113 in
+    let nodes = Hashtbl.create 13 in
+    iter (fun n v ->
+        NH.replace values n v;
+        let loc = UpdateCil.getLoc n in
+        Hashtbl.add nodes loc.file (loc.line, n)
+      );
+    let funs = Hashtbl.create 13 in
+    iterGlobals ast (function
+        | GFun (fd, loc) -> Hashtbl.add funs loc.file fd
+        | _ -> ()
+      );
+    let paths = List.sort_uniq String.compare (List.of_enum (Enum.append (Hashtbl.keys nodes) (Hashtbl.keys funs))) in
+    let files = List.mapi (fun id path -> {
+          id;
+          path;
+          funs = List.rev (Hashtbl.find_all funs path);
+          nodes = Hashtbl.find_all nodes path;
+        }) paths
+    in
+
+    index_page dir files;
+    globals_page dir iter_globals;
+    warnings_page dir files;
+    let warnings = warning_lines () in
+    let write_file file =
+      file_page live warnings dir file;
+      List.iter (fun (_, n) -> node_page dir n (NH.find values n)) file.nodes;
+      List.iter (fun fd -> fun_page cfg live dir file fd) file.funs
+    in
+    ignore (Timing.wrap "html files" (ProcessPool.fork_map ~jobs:(GobConfig.jobs ()) write_file) files)
+end
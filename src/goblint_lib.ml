@@ -48,6 +48,7 @@ module Events = Events
     The following modules help query the constraint system solution using semantic information. *)
 
 module AnalysisResult = AnalysisResult
+module HtmlOutput = HtmlOutput
 module ResultQuery = ResultQuery
 module VarQuery = VarQuery
 
@@ -181,6 +182,7 @@ module SpecLifters = SpecLifters
 module LongjmpLifter = LongjmpLifter
 module RecursionTermLifter = RecursionTermLifter
 module ContextGasLifter = ContextGasLifter
+module ContextLimitLifter = ContextLimitLifter
 module WideningToken = WideningToken
 module WideningTokenLifter = WideningTokenLifter
 
@@ -206,6 +208,7 @@ module SetDomain = SetDomain
 module MapDomain = MapDomain
 module TrieDomain = TrieDomain
 module DisjointDomain = DisjointDomain
+module BitsetDomain = BitsetDomain
 module HoareDomain = HoareDomain
 module PartitionDomain = PartitionDomain
 module FlagHelper = FlagHelper
@@ -305,6 +308,7 @@ module IntDomainProperties = IntDomainProperties
 module CompareCIL = CompareCIL
 module CompareAST = CompareAST
 module CompareCFG = CompareCFG
+module HashAST = HashAST
 module UpdateCil = UpdateCil
 module MaxIdUtil = MaxIdUtil
 module Serialize = Serialize
@@ -323,6 +327,8 @@ module Logs = Logs
     The following modules handle program input. *)
 
 module Preprocessor = Preprocessor
+module PreprocessorCache = PreprocessorCache
+module ParsedCache = ParsedCache
 module CompilationDatabase = CompilationDatabase
 module MakefileUtil = MakefileUtil
 module TerminationPreprocessing = TerminationPreprocessing
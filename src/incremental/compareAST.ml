@@ -319,17 +319,17 @@ let eq_instr (a: instr) (b: instr) ~(rename_mapping: rename_mapping) = match a,
   | _, _ -> false, rename_mapping
 
 
-let eq_label (a: label) (b: label) = match a, b with
-    Label (lb1, _l1, s1), Label (lb2, _l2, s2) -> lb1 = lb2 && s1 = s2
-  |   Case (exp1, _l1, _el1), Case (exp2, _l2, el_2) -> exp1 = exp2
-  | Default (_l1, _el1), Default (_l2, _el2) -> true
-  | _, _ -> false
+let eq_label (a: label) (b: label) ~(rename_mapping: rename_mapping) = match a, b with
+    Label (lb1, _l1, s1), Label (lb2, _l2, s2) -> (lb1 = lb2 && s1 = s2), rename_mapping
+  |   Case (exp1, _l1, _el1), Case (exp2, _l2, el_2) -> eq_exp exp1 exp2 ~rename_mapping (* ignore ids and locations in exp *)
+  | Default (_l1, _el1), Default (_l2, _el2) -> true, rename_mapping
+  | _, _ -> false, rename_mapping
 
 (* This is needed for checking whether a goto does go to the same semantic location/statement*)
-let eq_stmt_with_location ((a, af): stmt * fundec) ((b, bf): stmt * fundec) =
+let eq_stmt_with_location ((a, af): stmt * fundec) ((b, bf): stmt * fundec) ~(rename_mapping: rename_mapping) =
   let offsetA = a.sid - (List.hd af.sallstmts).sid in
   let offsetB = b.sid - (List.hd bf.sallstmts).sid in
-  GobList.equal eq_label a.labels b.labels && offsetA = offsetB
+  forward_list_equal eq_label a.labels b.labels ~rename_mapping &&> (offsetA = offsetB)
 
 (* cfg_comp: blocks need only be compared in the AST comparison. For cfg comparison of functions one instead walks
    through the cfg and only compares the currently visited node (The cil blocks inside an if statement should not be
@@ -343,7 +343,7 @@ let rec eq_stmtkind ?(cfg_comp = false) ((a, af): stmtkind * fundec) ((b, bf): s
   | Return (Some exp1, _l1, _el1), Return (Some exp2, _l2, _el2) -> eq_exp exp1 exp2 ~rename_mapping
   | Return (None, _l1, _el1), Return (None, _l2, _el2) -> true, rename_mapping
   | Return _, Return _ -> false, rename_mapping
-  | Goto (st1, _l1), Goto (st2, _l2) -> eq_stmt_with_location (!st1, af) (!st2, bf), rename_mapping
+  | Goto (st1, _l1), Goto (st2, _l2) -> eq_stmt_with_location (!st1, af) (!st2, bf) ~rename_mapping
   | Break _, Break _ -> if cfg_comp then failwith "CompareCFG: Invalid stmtkind in CFG" else true, rename_mapping
   | Continue _, Continue _ -> if cfg_comp then failwith "CompareCFG: Invalid stmtkind in CFG" else true, rename_mapping
   | If (exp1, then1, else1, _l1, _el1), If (exp2, then2, else2, _l2, _el2) -> eq_exp exp1 exp2 ~rename_mapping &&>>
@@ -355,11 +355,11 @@ let rec eq_stmtkind ?(cfg_comp = false) ((a, af): stmtkind * fundec) ((b, bf): s
   | _, _ -> false, rename_mapping
 
 and eq_stmt ?cfg_comp ((a, af): stmt * fundec) ((b, bf): stmt * fundec) ~(rename_mapping: rename_mapping) =
-  (GobList.equal eq_label a.labels b.labels, rename_mapping) &&>>
+  forward_list_equal eq_label a.labels b.labels ~rename_mapping &&>>
   eq_stmtkind ?cfg_comp (a.skind, af) (b.skind, bf)
 
 and eq_block ((a, af): Cil.block * fundec) ((b, bf): Cil.block * fundec) ~(rename_mapping: rename_mapping) : bool * rename_mapping =
-  (a.battrs = b.battrs, rename_mapping) &&>> forward_list_equal (fun x y -> eq_stmt (x, af) (y, bf)) a.bstmts b.bstmts
+  forward_list_equal (eq_attribute ~acc:[]) a.battrs b.battrs ~rename_mapping &&>> forward_list_equal (fun x y -> eq_stmt (x, af) (y, bf)) a.bstmts b.bstmts
 
 let rec eq_init (a: init) (b: init) ~(rename_mapping: rename_mapping) = match a, b with
   | SingleInit e1, SingleInit e2 -> eq_exp e1 e2 ~rename_mapping
@@ -286,10 +286,23 @@ let addOldGlobals name gc_old (change_info, final_matches) =
     change_info.removed <- gc_old :: change_info.removed;
   (change_info, final_matches)
 
-let compareCilFiles ?(eq=eq_glob) (oldAST: file) (newAST: file) =
-  let cfgs = if GobConfig.get_string "incremental.compare" = "cfg"
-    then Some Batteries.(CfgTools.getCFG oldAST |> Tuple3.first, CfgTools.getCFG newAST |> Tuple3.get12)
-    else None in
+(** Structural hash of a global collection, tagged by the kind of global compared by [eq_glob]. *)
+let hash_global_col session gc =
+  let tagged c = Option.map (fun h -> String.make 1 c ^ h) in
+  match gc.def, gc.decls with
+  | Some (Fun f), _ -> if should_reanalyze f then None else tagged 'F' (HashAST.fundec session f)
+  | Some (Var v), _ -> tagged 'V' (HashAST.varinfo session v)
+  | None, Some v -> tagged 'D' (HashAST.varinfo session v)
+  | None, None -> None
+
+let compareCilFiles ?eq ?(compare_cfgs=GobConfig.get_string "incremental.compare" = "cfg") (oldAST: file) (newAST: file) =
+  (* globals with equal structural hashes are unchanged without running [eq], unless a custom [eq] is given *)
+  let hashing = Option.is_none eq && GobConfig.get_bool "incremental.compare-hashes" in
+  let eq = Option.value eq ~default:eq_glob in
+  (* CFGs are only needed if some global is compared by [eq] *)
+  let cfgs = lazy (if compare_cfgs
+                   then Some Batteries.(CfgTools.getCFG oldAST |> Tuple3.first, CfgTools.getCFG newAST |> Tuple3.get12)
+                   else None) in
 
   let addGlobal map global =
     try
@@ -318,10 +331,50 @@ let compareCilFiles ?(eq=eq_glob) (oldAST: file) (newAST: file) =
   let changes = empty_change_info () in
   global_typ_acc := [];
 
+  (* Hashes of the old file are reused from the previous comparison, if it produced the old file. *)
+  let old_hashes = match Serialize.Cache.(get_opt_data GlobalHashes) with
+    | Some (file, hashes) when hashing && file == oldAST -> hashes
+    | _ -> Hashtbl.create 113
+  in
+  let old_session = lazy (HashAST.create ()) in
+  let old_hash name gc_old =
+    match Hashtbl.find_opt old_hashes name with
+    | Some h -> Some h
+    | None -> hash_global_col (Lazy.force old_session) gc_old
+  in
+  (* Hash all new globals before comparing, because successful comparisons may rename anonymous types in the new file. *)
+  let new_hashes =
+    if hashing then (
+      let new_session = HashAST.create () in
+      GlobalMap.filter_map (fun _ gc_new -> hash_global_col new_session gc_new) newMap
+    )
+    else
+      GlobalMap.empty
+  in
+  let hash_matched = Hashtbl.create 113 in
+
+  let is_kind ~matchVars ~matchFuns gc = match gc.def with
+    | Some (Fun _) -> matchFuns
+    | Some (Var _) | None -> matchVars
+  in
+  let matched_by_hash ~matchVars ~matchFuns name gc_old gc_new final_matches =
+    match GlobalMap.find_opt name new_hashes with
+    | Some h when is_kind ~matchVars ~matchFuns gc_new && not (VarinfoMap.mem (get_varinfo gc_old) (fst final_matches)) ->
+      Option.equal String.equal (old_hash name gc_old) (Some h)
+    | _ -> false
+  in
+
   let findChanges ?(matchVars=true) ?(matchFuns=true) ?(renameDetection=false) oldMap newMap cfgs name gc_new (change_info, final_matches) =
     try
       let gc_old = GlobalMap.find name oldMap in
-      eq ~matchVars ~matchFuns ~renameDetection oldMap newMap cfgs gc_old gc_new (change_info, final_matches)
+      if matched_by_hash ~matchVars ~matchFuns name gc_old gc_new final_matches then (
+        Logs.debug "Unchanged by hash: %s" name;
+        Hashtbl.replace hash_matched name (GlobalMap.find name new_hashes);
+        change_info.unchanged <- {old = gc_old; current = gc_new} :: change_info.unchanged;
+        change_info, addToFinalMatchesMapping (get_varinfo gc_old) (get_varinfo gc_new) final_matches
+      )
+      else
+        eq ~matchVars ~matchFuns ~renameDetection oldMap newMap (Lazy.force cfgs) gc_old gc_new (change_info, final_matches)
     with Not_found ->
       if not renameDetection then
         change_info.added <- gc_new::change_info.added; (* Global could not be found in old map -> added *)
@@ -343,9 +396,13 @@ let compareCilFiles ?(eq=eq_glob) (oldAST: file) (newAST: file) =
       |> GlobalMap.fold addOldGlobals oldMap in
     ()
   );
+  (* Only hashes of globals matched by hash are kept: others may have been invalidated by renames of anonymous types. *)
+  if hashing && (GobConfig.get_bool "incremental.save" || Serialize.server ()) then
+    Serialize.Cache.(update_data GlobalHashes (newAST, hash_matched));
   changes
 
 (** Given an (optional) equality function between [Cil.global]s, an old and a new [Cil.file], this function computes a [change_info],
-    which describes which [global]s are changed, unchanged, removed and added.  *)
-let compareCilFiles ?eq (oldAST: file) (newAST: file) =
-  Timing.wrap "compareCilFiles" (compareCilFiles ?eq oldAST) newAST
+    which describes which [global]s are changed, unchanged, removed and added.
+    The CFGs of both files are only computed if [compare_cfgs] (default: [incremental.compare] is [cfg]). *)
+let compareCilFiles ?eq ?compare_cfgs (oldAST: file) (newAST: file) =
+  Timing.wrap "compareCilFiles" (compareCilFiles ?eq ?compare_cfgs oldAST) newAST
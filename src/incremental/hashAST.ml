@@ -0,0 +1,246 @@
+(** Structural hashes of CIL globals for {!CompareCIL}.
+
+    Equal hashes imply that {!CompareAST} considers two globals equal without any rename assumptions.
+    Hashes distinguish more in some places (e.g. names of locals and anonymous types), so unequal hashes still need a full comparison. *)
+
+open GoblintCil
+
+module CompinfoH = Hashtbl.Make (CilType.Compinfo)
+
+(** Raised for globals, which {!CompareAST} never considers equal (e.g. containing [AddrOfLabel]). *)
+exception Unhashable
+
+(** Hashing state for one file. *)
+type t = {
+  shallow: (Digest.t * compinfo list) CompinfoH.t; (** Digest of compinfo, where referenced compinfos are only named, and the referenced compinfos. *)
+  closed: Digest.t CompinfoH.t; (** Digest of compinfo including all (transitively) referenced compinfos. *)
+}
+
+let create (): t = {
+  shallow = CompinfoH.create 113;
+  closed = CompinfoH.create 113;
+}
+
+let tag b c = Buffer.add_char b c
+let int b i =
+  Buffer.add_string b (string_of_int i);
+  Buffer.add_char b ';'
+let string b s =
+  int b (String.length s);
+  Buffer.add_string b s
+let bool b x = tag b (if x then 't' else 'f')
+let list f b xs =
+  int b (List.length xs);
+  List.iter (f b) xs
+let option f b = function
+  | None -> tag b 'n'
+  | Some x -> tag b 's'; f b x
+
+(** For parts, which {!CompareAST} compares by polymorphic equality. *)
+let marshal b x = string b (Marshal.to_string x [])
+
+let storage b = function
+  | NoStorage -> tag b '0'
+  | Static -> tag b '1'
+  | Register -> tag b '2'
+  | Extern -> tag b '3'
+
+(* Serializers are parameterized by the serialization of referenced compinfos. *)
+
+let rec typ comp b = function
+  | TVoid a -> tag b 'v'; attributes comp b a
+  | TInt (ik, a) -> tag b 'i'; int b (CilType.Ikind.hash ik); attributes comp b a
+  | TFloat (fk, a) -> tag b 'f'; int b (CilType.Fkind.hash fk); attributes comp b a
+  | TPtr (t, a) -> tag b 'p'; typ comp b t; attributes comp b a
+  | TArray (t, len, a) -> tag b 'a'; typ comp b t; option (exp comp) b len; attributes comp b a
+  | TFun (r, args, va, a) ->
+    tag b 'F';
+    typ comp b r;
+    option (list (fun b (name, t, a) -> string b name; typ comp b t; attributes comp b a)) b args;
+    bool b va;
+    attributes comp b a
+  | TNamed (ti, a) -> tag b 'N'; typ comp b ti.ttype; attributes comp b a (* ignore tname *)
+  | TComp (ci, a) -> tag b 'C'; comp b ci; attributes comp b a
+  | TEnum (ei, a) -> tag b 'E'; enuminfo comp b ei; attributes comp b a
+  | TBuiltin_va_list a -> tag b 'B'; attributes comp b a
+
+and enuminfo comp b ei =
+  string b ei.ename;
+  attributes comp b ei.eattr;
+  list (fun b (name, a, e, _) -> string b name; attributes comp b a; exp comp b e) b ei.eitems
+
+and attributes comp b a = list (attribute comp) b a
+
+and attribute comp b (Attr (name, params)) =
+  string b name;
+  list (attrparam comp) b params
+
+and attrparam comp b = function
+  | ACons (s, ps) -> tag b 'c'; string b s; list (attrparam comp) b ps
+  | ASizeOf t -> tag b 'z'; typ comp b t
+  | ASizeOfE p -> tag b 'Z'; attrparam comp b p
+  | ASizeOfS ts -> tag b 'y'; marshal b ts
+  | AAlignOf t -> tag b 'l'; typ comp b t
+  | AAlignOfE p -> tag b 'L'; attrparam comp b p
+  | AAlignOfS ts -> tag b 'Y'; marshal b ts
+  | AUnOp (op, p) -> tag b 'u'; int b (CilType.Unop.hash op); attrparam comp b p
+  | ABinOp (op, l, r) -> tag b 'o'; int b (CilType.Binop.hash op); attrparam comp b l; attrparam comp b r
+  | ADot (p, s) -> tag b '.'; attrparam comp b p; string b s
+  | AStar p -> tag b '*'; attrparam comp b p
+  | AAddrOf p -> tag b '&'; attrparam comp b p
+  | AIndex (l, r) -> tag b '['; attrparam comp b l; attrparam comp b r
+  | AQuestion (c, t, f) -> tag b '?'; attrparam comp b c; attrparam comp b t; attrparam comp b f
+  | AAssign (l, r) -> tag b '='; attrparam comp b l; attrparam comp b r
+  | p -> tag b 'P'; marshal b p
+
+and constant comp b = function
+  | CInt (z, ik, _) -> tag b 'i'; string b (Z.to_string z); int b (CilType.Ikind.hash ik) (* ignore string representation *)
+  | CEnum (e, _, _) -> tag b 'e'; exp comp b e (* ignore name and enuminfo *)
+  | CReal (f, _, _) when Float.is_nan f -> raise Unhashable
+  | c -> tag b 'K'; marshal b c
+
+and exp comp b = function
+  | Const c -> tag b 'k'; constant comp b c
+  | Lval lv -> tag b 'l'; lval comp b lv
+  | SizeOf t -> tag b 'z'; typ comp b t
+  | SizeOfE e -> tag b 'Z'; exp comp b e
+  | SizeOfStr s -> tag b 'S'; string b s
+  | AlignOf t -> tag b 'a'; typ comp b t
+  | AlignOfE e -> tag b 'A'; exp comp b e
+  | UnOp (op, e, t) -> tag b 'u'; int b (CilType.Unop.hash op); exp comp b e; typ comp b t
+  | BinOp (op, l, r, t) -> tag b 'o'; int b (CilType.Binop.hash op); exp comp b l; exp comp b r; typ comp b t
+  | CastE (t, e) -> tag b 'c'; typ comp b t; exp comp b e
+  | AddrOf lv -> tag b '&'; lval comp b lv
+  | StartOf lv -> tag b 's'; lval comp b lv
+  | Real e -> tag b 'r'; exp comp b e
+  | Imag e -> tag b 'i'; exp comp b e
+  | Question (c, t, f, ty) -> tag b '?'; exp comp b c; exp comp b t; exp comp b f; typ comp b ty
+  | AddrOfLabel _ -> raise Unhashable
+
+and lval comp b (host, off) =
+  begin match host with
+    | Var v -> tag b 'v'; varinfo comp b v
+    | Mem e -> tag b 'm'; exp comp b e
+  end;
+  offset comp b off
+
+and offset comp b = function
+  | NoOffset -> tag b 'n'
+  | Field (fi, off) -> tag b 'f'; fieldinfo comp b fi; offset comp b off
+  | Index (e, off) -> tag b 'i'; exp comp b e; offset comp b off
+
+and fieldinfo comp b fi =
+  string b fi.fname;
+  typ comp b fi.ftype;
+  option int b fi.fbitfield;
+  attributes comp b fi.fattr
+
+and varinfo comp b v =
+  string b v.vname;
+  typ comp b v.vtype;
+  attributes comp b v.vattr;
+  storage b v.vstorage;
+  bool b v.vglob;
+  bool b v.vaddrof
+
+let instr comp b = function
+  | Set (lv, e, _, _) -> tag b 's'; lval comp b lv; exp comp b e
+  | Call (lv, f, args, _, _) -> tag b 'c'; option (lval comp) b lv; exp comp b f; list (exp comp) b args
+  | Asm (_, tmpl, outs, ins, clobbers, _) ->
+    tag b 'a';
+    list string b tmpl;
+    list (fun b (name, constr, lv) -> option string b name; string b constr; lval comp b lv) b outs;
+    list (fun b (name, constr, e) -> option string b name; string b constr; exp comp b e) b ins;
+    list string b clobbers
+  | VarDecl (v, _) -> tag b 'd'; varinfo comp b v
+
+let label comp b = function
+  | Label (name, _, user) -> tag b 'l'; string b name; bool b user
+  | Case (e, _, _) -> tag b 'c'; exp comp b e
+  | Default _ -> tag b 'd'
+  | _ -> raise Unhashable
+
+let first_sid (fd: fundec) = match fd.sallstmts with
+  | s :: _ -> s.sid
+  | [] -> 0
+
+let rec stmt comp fd b s =
+  list (label comp) b s.labels;
+  match s.skind with
+  | Instr is -> tag b 'i'; list (instr comp) b is
+  | Return (e, _, _) -> tag b 'r'; option (exp comp) b e
+  | Goto (target, _) -> tag b 'g'; list (label comp) b !target.labels; int b (!target.sid - first_sid fd) (* like CompareAST.eq_stmt_with_location *)
+  | Break _ -> tag b 'b'
+  | Continue _ -> tag b 'C'
+  | If (e, t, f, _, _) -> tag b '?'; exp comp b e; block comp fd b t; block comp fd b f
+  | Switch (e, blk, cases, _, _) -> tag b 's'; exp comp b e; block comp fd b blk; list (stmt comp fd) b cases
+  | Loop (blk, _, _, _, _) -> tag b 'L'; block comp fd b blk
+  | Block blk -> tag b 'B'; block comp fd b blk
+  | _ -> raise Unhashable
+
+and block comp fd b blk =
+  attributes comp b blk.battrs;
+  list (stmt comp fd) b blk.bstmts
+
+(** Digest of [ci] with referenced compinfos only by name. *)
+let shallow (h: t) ci =
+  match CompinfoH.find_opt h.shallow ci with
+  | Some r -> r
+  | None ->
+    let refs = ref [] in
+    let comp b ci' =
+      string b ci'.cname;
+      refs := ci' :: !refs
+    in
+    let b = Buffer.create 64 in
+    bool b ci.cstruct;
+    string b ci.cname;
+    list (fieldinfo comp) b ci.cfields;
+    attributes comp b ci.cattr;
+    bool b ci.cdefined;
+    let r = (Digest.string (Buffer.contents b), List.rev !refs) in
+    CompinfoH.replace h.shallow ci r;
+    r
+
+(** Digest of the (possibly cyclic) graph of compinfos reachable from [ci].
+    Nodes are numbered in DFS order, such that equal digests imply that {!CompareAST.eq_compinfo} holds. *)
+let closed (h: t) ci =
+  match CompinfoH.find_opt h.closed ci with
+  | Some d -> d
+  | None ->
+    let b = Buffer.create 64 in
+    let visited = CompinfoH.create 8 in
+    let rec visit ci =
+      match CompinfoH.find_opt visited ci with
+      | Some i -> tag b 'r'; int b i
+      | None ->
+        CompinfoH.replace visited ci (CompinfoH.length visited);
+        let (d, refs) = shallow h ci in
+        tag b 'c';
+        Buffer.add_string b d;
+        List.iter visit refs
+    in
+    visit ci;
+    let d = Digest.string (Buffer.contents b) in
+    CompinfoH.replace h.closed ci d;
+    d
+
+let digest h f x =
+  let b = Buffer.create 256 in
+  let comp b ci = Buffer.add_string b (closed h ci) in
+  match f comp b x with
+  | () -> Some (Digest.string (Buffer.contents b))
+  | exception Unhashable -> None
+
+(** Hash of a function definition, like {!CompareCIL.eqF} without CFGs. *)
+let fundec h (fd: fundec) =
+  digest h (fun comp b fd ->
+      varinfo comp b fd.svar;
+      list (varinfo comp) b fd.sformals;
+      list (varinfo comp) b fd.slocals;
+      block comp fd b fd.sbody
+    ) fd
+
+(** Hash of a global variable (or declaration), like {!CompareCIL.eq_glob_var}. *)
+let varinfo h (v: varinfo) =
+  digest h varinfo v
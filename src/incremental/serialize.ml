@@ -41,28 +41,43 @@ module Cache = struct
   type t = {
     mutable solver_data: Obj.t option;
     mutable analysis_data: Obj.t option;
+    mutable thresholds: Obj.t option; (** Per-function widening thresholds. *)
     mutable version_data: MaxIdUtil.max_ids option;
     mutable cil_file: GoblintCil.file option;
+    mutable global_hashes: (GoblintCil.file * (string, Digest.t) Hashtbl.t) option; (** Structural hashes of globals in a file by {!HashAST}. *)
+    mutable settings: (string * Yojson.Safe.t) list; (** Values of {!settings} when the data was stored. *)
   }
 
   let data = ref {
       solver_data = None;
       analysis_data = None;
+      thresholds = None;
       version_data = None;
       cil_file = None;
+      global_hashes = None;
+      settings = [];
     }
 
+  (** Options, which determine the representation of the data, so it can only be loaded with the same values. *)
+  let settings = ["solvers.td3.intern"; "ana.base.addresses.domain"]
+
   (** GADT that may be used to query data from and pass data to the cache. *)
   type _ data_query =
     | SolverData : _ data_query
     | CilFile : GoblintCil.file data_query
     | VersionData : MaxIdUtil.max_ids data_query
     | AnalysisData : _ data_query
+    | Thresholds : _ data_query
+    | GlobalHashes : (GoblintCil.file * (string, Digest.t) Hashtbl.t) data_query
 
   (** Loads data for incremental runs from the appropriate file *)
   let load_data () =
     let p = Fpath.(gob_results_dir Load / incremental_data_file_name) in
     let loaded_data = unmarshal p in
+    List.iter (fun (name, value) ->
+        if not (Yojson.Safe.equal (GobConfig.get_json name) value) then
+          failwith (Printf.sprintf "Incremental data was stored with %s = %s" name (Yojson.Safe.to_string value))
+      ) loaded_data.settings;
     data := loaded_data
 
   (** Stores data for future incremental runs at the appropriate file. *)
@@ -71,29 +86,36 @@ module Cache = struct
     let d = gob_results_dir Save in
     GobSys.mkdir_or_exists d;
     let p = Fpath.(d / incremental_data_file_name) in
+    !data.settings <- List.map (fun name -> (name, GobConfig.get_json name)) settings;
     marshal !data p
 
   (** Update the incremental data in the in-memory cache *)
   let update_data: type a. a data_query -> a -> unit = fun q d -> match q with
     | SolverData -> !data.solver_data <- Some (Obj.repr d)
     | AnalysisData -> !data.analysis_data <- Some (Obj.repr d)
+    | Thresholds -> !data.thresholds <- Some (Obj.repr d)
     | VersionData -> !data.version_data <- Some d
     | CilFile -> !data.cil_file <- Some d
+    | GlobalHashes -> !data.global_hashes <- Some d
 
   (** Reset some incremental data in the in-memory cache to [None]*)
   let reset_data : type a. a data_query -> unit = function
     | SolverData -> !data.solver_data <- None
     | AnalysisData -> !data.analysis_data <- None
+    | Thresholds -> !data.thresholds <- None
     | VersionData -> !data.version_data <- None
     | CilFile -> !data.cil_file <- None
+    | GlobalHashes -> !data.global_hashes <- None
 
   (** Get incremental data from the in-memory cache wrapped in an optional.
       To populate the in-memory cache with data, call [load_data] first. *)
   let get_opt_data : type a. a data_query -> a option = function
     | SolverData -> Option.map Obj.obj !data.solver_data
     | AnalysisData -> Option.map Obj.obj !data.analysis_data
+    | Thresholds -> Option.map Obj.obj !data.thresholds
     | VersionData -> !data.version_data
     | CilFile -> !data.cil_file
+    | GlobalHashes -> !data.global_hashes
 
   (** Get incremental data from the in-memory cache.
       Same as [get_opt_data], except not yielding an optional and failing when the requested data is not present. *)
@@ -0,0 +1,75 @@
+(** Lifts a [Spec] such that functions with too many contexts share a context.
+    The contexts of each function are counted while solving. The first [ana.context.limit] contexts of a function are kept,
+    all further ones are merged into a single context without context value, like with exhausted context gas.
+    Solving continues without restarting. *)
+
+open Analyses
+open GobConfig
+
+module NoContext = struct let name = "no context" end
+
+module FH = Hashtbl.Make (CilType.Fundec)
+
+module Lifter (S: Spec)
+  : Spec with module D = S.D
+          and module C = Printable.Option (S.C) (NoContext)
+          and module G = S.G
+=
+struct
+  include S
+
+  module C = Printable.Option (S.C) (NoContext)
+
+  module CH = Hashtbl.Make (S.C)
+
+  (** Kept contexts of each function, reset for each analysis. *)
+  let contexts: unit CH.t FH.t = FH.create 113
+
+  let name () = S.name () ^ " with context limit"
+
+  let init marshal =
+    FH.clear contexts;
+    S.init marshal
+
+  let startcontext () = Some (S.startcontext ())
+
+  let conv (man:(D.t,G.t,C.t,V.t) man): (S.D.t,G.t,S.C.t,V.t) man =
+    {man with context = (fun () -> match man.context () with Some c -> c | None -> man_failwith "no context (context limit exceeded)")}
+
+  (* Contexts are kept once they are seen, so re-evaluating a caller (also by the postsolver) yields the same context as before. *)
+  let context man fd d =
+    let c = S.context (conv man) fd d in
+    let cs = match FH.find_opt contexts fd with
+      | Some cs -> cs
+      | None ->
+        let cs = CH.create 13 in
+        FH.replace contexts fd cs;
+        cs
+    in
+    if CH.mem cs c then
+      Some c
+    else if CH.length cs < get_int "ana.context.limit" then (
+      CH.replace cs c ();
+      Some c
+    )
+    else
+      None
+
+  let sync man reason = S.sync (conv man) reason
+  let query man (type a) (q: a Queries.t): a Queries.result = S.query (conv man) q
+  let assign man lv e = S.assign (conv man) lv e
+  let vdecl man v = S.vdecl (conv man) v
+  let branch man e tv = S.branch (conv man) e tv
+  let body man f = S.body (conv man) f
+  let return man r f = S.return (conv man) r f
+  let asm man = S.asm (conv man)
+  let skip man = S.skip (conv man)
+  let special man r f args = S.special (conv man) r f args
+  let enter man r f args = S.enter (conv man) r f args
+  let combine_env man r fe f args fc es f_ask = S.combine_env (conv man) r fe f args (Option.bind fc Fun.id) es f_ask
+  let combine_assign man r fe f args fc es f_ask = S.combine_assign (conv man) r fe f args (Option.bind fc Fun.id) es f_ask
+  let paths_as_set man = S.paths_as_set (conv man)
+  let threadenter man ~multiple lval f args = S.threadenter (conv man) ~multiple lval f args
+  let threadspawn man ~multiple lval f args fman = S.threadspawn (conv man) ~multiple lval f args (conv fman)
+  let event man e oman = S.event (conv man) e (conv oman)
+end
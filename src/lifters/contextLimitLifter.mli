@@ -0,0 +1,6 @@
+(** Lifts a [Spec] such that functions with too many contexts share a context.
+    The contexts of each function are counted while solving. The first [ana.context.limit] contexts of a function are kept,
+    all further ones are merged into a single context without context value, like with exhausted context gas.
+    Solving continues without restarting. *)
+
+module Lifter : Analyses.Spec2Spec
@@ -63,7 +63,6 @@ let rec option_spec_list: Arg_complete.speclist Lazy.t = lazy (
       set_string "outfile" "result";
     if get_string "exp.g2html_path" = "" then
       set_string "exp.g2html_path" (Fpath.to_string GobSys.exe_dir);
-    set_bool "exp.cfgdot" true;
     set_bool "g2html" true;
     set_string "result" "fast_xml"
   in
@@ -119,6 +118,7 @@ let rec option_spec_list: Arg_complete.speclist Lazy.t = lazy (
   ; "--help"               , Arg_complete.Unit (fun _ -> print_help stdout),""
   ; "--html"               , Arg_complete.Unit (fun _ -> configure_html ()),""
   ; "--sarif"               , Arg_complete.Unit (fun _ -> configure_sarif ()),""
+  ; "--resume"             , Arg_complete.Unit (fun _ -> set_bool "incremental.load" true), ""
   ; "--compare_runs"       , Arg_complete.Tuple [Arg_complete.Set_string (tmp_arg, Arg_complete.empty); Arg_complete.String ((fun x -> set_auto "compare_runs" (sprintf "['%s','%s']" !tmp_arg x)), Arg_complete.empty)], ""
   ; "--complete"           , Arg_complete.Rest_all (complete, Arg_complete.empty_all), ""
   ] @ defaults_spec_list (* lowest priority *)
@@ -143,6 +143,10 @@ let check_arguments () =
   if get_bool "ana.base.context.interval" && not (get_bool "ana.base.context.int") then (set_bool "ana.base.context.interval" false; warn "ana.base.context.interval implicitly disabled by ana.base.context.int");
   if get_bool "incremental.only-rename" then (set_bool "incremental.load" true; warn "incremental.only-rename implicitly activates incremental.load. Previous AST is loaded for diff and rename, but analyis results are not reused.");
   if get_bool "incremental.restart.sided.enabled" && get_string_list "incremental.restart.list" <> [] then warn "Passing a non-empty list to incremental.restart.list (manual restarting) while incremental.restart.sided.enabled (automatic restarting) is activated.";
+  if Goblint_solver.SolverCheckpoint.enabled () && not (get_bool "incremental.save") then (set_bool "incremental.save" true; warn "incremental.checkpoint implicitly activates incremental.save");
+  if Goblint_solver.SolverCheckpoint.enabled () && get_bool "solvers.td3.skip-unchanged-rhs" then warn "incremental.checkpoint is ignored with solvers.td3.skip-unchanged-rhs";
+  (* checkpoints finalize the analyses to store their data, which would also write these outputs *)
+  if Goblint_solver.SolverCheckpoint.enabled () && (get_string "exp.priv-prec-dump" <> "" || get_string "exp.relation.prec-dump" <> "" || List.mem "extract-pthread" @@ get_string_list "ana.activated") then fail "incremental.checkpoint is incompatible with exp.priv-prec-dump, exp.relation.prec-dump and the extract-pthread analysis";
   if get_bool "ana.autotune.enabled" && get_bool "incremental.load" then (set_bool "ana.autotune.enabled" false; warn "ana.autotune.enabled implicitly disabled by incremental.load");
   if get_bool "exp.basic-blocks" && not (get_bool "justcil") && List.mem "assert" @@ get_string_list "trans.activated" then (set_bool "exp.basic-blocks" false; warn "The option exp.basic-blocks implicitely disabled by activating the \"assert\" tranformation.");
   if (not @@ get_bool "witness.invariant.all-locals") && (not @@ get_bool "cil.addNestedScopeAttr") then (set_bool "cil.addNestedScopeAttr" true; warn "Disabling witness.invariant.all-locals implicitly enables cil.addNestedScopeAttr.");
@@ -170,6 +174,8 @@ let check_arguments () =
     set_string "sem.int.signed_overflow" "assume_none";
     warn "termination analysis implicitly activates threadflag analysis and set sem.int.signed_overflow to assume_none";
   );
+  if get_string "ana.base.addresses.domain" = "bitset" && get_bool "incremental.load" && not (get_bool "server.enabled") then fail "ana.base.addresses.domain = 'bitset' is incompatible with incremental.load";
+  if get_string "ana.base.addresses.domain" = "bitset" && get_string "load_run" <> "" then fail "ana.base.addresses.domain = 'bitset' is incompatible with load_run";
   if not (get_bool "ana.sv-comp.enabled") && get_bool "witness.graphml.enabled" then fail "witness.graphml.enabled: cannot generate GraphML witness without SV-COMP mode (ana.sv-comp.enabled)";
   if get_bool "dbg.print_wpoints" && not (Logs.Level.should_log Debug) then
     warn "dbg.print_wpoints requires dbg.level debug";
@@ -269,6 +275,8 @@ let basic_preprocess ?preprocess ~all_cppflags fname =
 let preprocess_files () =
   Preprocessor.FpathH.clear basic_preprocess_counts;
   Preprocessor.FpathH.clear Preprocessor.dependencies; (* clear for server mode *)
+  PreprocessorCache.reset ();
+  ParsedCache.reset ();
 
   (* Preprocessor flags *)
   let cppflags = ref (get_string_list "pre.cppflags") in
@@ -428,7 +436,27 @@ let preprocess_files () =
     List.concat_map (preprocess_arg_file ~preprocess:true) !extra_files
   in
   if not (get_bool "pre.exist") then (
-    let preprocess_tasks = List.filter_map snd preprocessed in
+    (* translation units reused from the parsed cache need not be preprocessed *)
+    let unparsed =
+      if ParsedCache.enabled () then
+        List.filter (fun (preprocessed_file, task) -> not (ParsedCache.valid preprocessed_file task)) preprocessed
+      else
+        preprocessed
+    in
+    let preprocess_tasks = List.filter_map snd unparsed in
+    let preprocess_tasks =
+      if PreprocessorCache.enabled () then (
+        let tasks = List.filter_map (function
+            | (preprocessed_file, Some task) when not (PreprocessorCache.restore preprocessed_file task) -> Some task
+            | _ -> None
+          ) unparsed
+        in
+        Logs.info "Preprocessing cache: %d hits, %d misses" !PreprocessorCache.hits (List.length tasks);
+        tasks
+      )
+      else
+        preprocess_tasks
+    in
     let terminated (task: ProcessPool.task) = function
       | Unix.WEXITED 0 -> ()
       | process_status ->
@@ -454,15 +482,18 @@ let parse_preprocessed preprocessed =
         (path_str, system_header) (* ignore special "paths" *)
       else
         let path = Fpath.v path_str in
+        let cwd_opt =
+          let open GobOption.Syntax in
+          let* task = task_opt in
+          task.ProcessPool.cwd
+        in
+        let dir = cwd_opt |? goblint_cwd in (* relative to compilation database directory or goblint's cwd *)
+        let absolute_path = Fpath.normalize @@ Fpath.append dir path in
+        PreprocessorCache.add_dependency preprocessed_file absolute_path;
+        if ParsedCache.enabled () then
+          ParsedCache.add_dependency preprocessed_file absolute_path;
         let path' = if get_bool "pre.transform-paths" then (
-            let cwd_opt =
-              let open GobOption.Syntax in
-              let* task = task_opt in
-              task.ProcessPool.cwd
-            in
-            let dir = cwd_opt |? goblint_cwd in (* relative to compilation database directory or goblint's cwd *)
-            let path' = Fpath.normalize @@ Fpath.append dir path in
-            Fpath.rem_prefix goblint_cwd path' |? path' (* remove goblint cwd prefix (if has one) for readability *)
+            Fpath.rem_prefix goblint_cwd absolute_path |? absolute_path (* remove goblint cwd prefix (if has one) for readability *)
           )
           else
             path
@@ -476,15 +507,33 @@ let parse_preprocessed preprocessed =
     in
     Errormsg.transformLocation := transformLocation;
 
+    if ParsedCache.enabled () && Option.is_none task_opt then
+      ParsedCache.add_dependency preprocessed_file (Fpath.normalize @@ Fpath.append goblint_cwd preprocessed_file); (* not preprocessed, so it is a dependency itself *)
+
     try
-      Cilfacade.getAST preprocessed_file
+      let ast = Cilfacade.getAST preprocessed_file in
+      PreprocessorCache.store preprocessed_file;
+      if ParsedCache.enabled () then
+        ParsedCache.store preprocessed_file task_opt ast;
+      ast
     with
     | Frontc.ParseError s ->
       raise (FrontendError (Format.sprintf "Frontc.ParseError: %s" s))
     | Errormsg.Error ->
       raise (FrontendError "Errormsg.Error")
   in
-  List.map get_ast_and_record_deps preprocessed
+  let get_ast (preprocessed_file, task_opt) =
+    if ParsedCache.enabled () && ParsedCache.valid preprocessed_file task_opt then
+      ParsedCache.restore preprocessed_file
+    else
+      get_ast_and_record_deps (preprocessed_file, task_opt)
+  in
+  let asts = List.map get_ast preprocessed in
+  if ParsedCache.enabled () then (
+    ParsedCache.retain (List.map fst preprocessed);
+    Logs.info "Parsing: %d translation units reused, %d parsed" !ParsedCache.reused (List.length preprocessed - !ParsedCache.reused)
+  );
+  asts
 
 (** Merge parsed files *)
 let merge_parsed parsed =
@@ -580,7 +629,7 @@ let do_analyze change_info merged_AST =
   )
 
 let do_html_output () =
-  if get_bool "g2html" then (
+  if get_bool "g2html" && not (get_bool "exp.g2html_native") then (
     let jar = Fpath.(v (get_string "exp.g2html_path") / "g2html.jar") in
     if Sys.file_exists (Fpath.to_string jar) then (
       let command = Filename.quote_command "java" [
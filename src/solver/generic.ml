@@ -71,10 +71,19 @@ struct
   let eval_rhs_event x =
     if tracing && full_trace then trace "sol" "(Re-)evaluating %a" Var.pretty_trace x;
     incr SolverStats.evals;
+    !AnalysisState.poll ();
     if (get_bool "dbg.solver-progress") then (incr stack_d; Logs.debug "%d" !stack_d)
 
+  (* JSON Lines stream of statistics for dbg.telemetry *)
+  let telemetry =
+    let telemetry_str = GobConfig.get_string "dbg.telemetry" in
+    if telemetry_str <> "" then
+      Some (open_out telemetry_str)
+    else
+      None
+
   let update_var_event x o n =
-    if tracing then increase x;
+    if tracing || Option.is_some telemetry then increase x;
     if full_trace || (not (Dom.is_bot o) && GobOption.exists (Var.equal x) !max_var) then begin
       if tracing then tracei "sol_max" "(%d) Update to %a" !max_c Var.pretty_trace x;
       if tracing then traceu "sol_max" "%a" Dom.pretty_diff (n, o)
@@ -83,23 +92,35 @@ struct
   (* solvers can assign this to print solver specific statistics using their data structures *)
   let print_solver_stats = ref (fun () -> ())
 
-  (* this can be used in print_solver_stats *)
-  let ncontexts = ref 0
-  let print_context_stats rho =
+  (* solvers can assign this to add solver specific fields to telemetry using their data structures *)
+  let solver_telemetry: (unit -> (string * Yojson.Safe.t) list) ref = ref (fun () -> [])
+
+  (* this can be used in print_solver_stats and solver_telemetry *)
+  let context_histo rho =
     let histo = Hashtbl.create 13 in (* histogram: node id -> number of contexts *)
     let str k = GobPretty.sprint S.Var.pretty_trace k in (* use string as key since k may have cycles which lead to exception *)
     let is_fun k = match S.Var.node k with FunctionEntry _ -> true | _ -> false in (* only count function entries since other nodes in function will have leq number of contexts *)
     HM.iter (fun k _ -> if is_fun k then Hashtbl.modify_def 0 (str k) ((+)1) histo) rho;
+    Hashtbl.to_list histo
+    |> List.sort (fun (_,n1) (_,n2) -> compare n2 n1)
+
+  (* this can be used in print_solver_stats *)
+  let ncontexts = ref 0
+  let print_context_stats rho =
+    let histo = context_histo rho in
     (* let max_k, n = Hashtbl.fold (fun k v (k',v') -> if v > v' then k,v else k',v') histo (Obj.magic (), 0) in *)
     (* Logs.debug "max #contexts: %d for %s" n max_k; *)
-    ncontexts := Hashtbl.fold (fun _ -> (+)) histo 0;
+    ncontexts := List.fold_left (fun acc (_, n) -> acc + n) 0 histo;
     let topn = 5 in
-    Logs.debug "Found %d contexts for %d functions. Top %d functions:" !ncontexts (Hashtbl.length histo) topn;
-    Hashtbl.to_list histo
-    |> List.sort (fun (_,n1) (_,n2) -> compare n2 n1)
+    Logs.debug "Found %d contexts for %d functions. Top %d functions:" !ncontexts (List.length histo) topn;
+    histo
     |> List.take topn
     |> List.iter @@ fun (k,n) -> Logs.debug "%d\tcontexts for %s" n k
 
+  (* this can be used in solver_telemetry *)
+  let context_telemetry rho =
+    `Assoc (List.map (fun (k, n) -> (k, `Int n)) (context_histo rho))
+
   let stats_csv =
     let save_run_str = GobConfig.get_string "save_run" in
     if save_run_str <> "" then (
@@ -109,6 +130,35 @@ struct
     ) else None
   let write_csv xs oc = output_string oc @@ String.concat ",\t" xs ^ "\n"
 
+  let last_telemetry = ref (Unix.gettimeofday (), 0)
+  let write_telemetry oc =
+    let time = Unix.gettimeofday () in
+    let (last_time, last_evals) = !last_telemetry in
+    last_telemetry := (time, !SolverStats.evals);
+    let gc = Gc.quick_stat () in
+    let topn = 10 in
+    let hottest =
+      HM.fold (fun x n acc -> (x, n) :: acc) histo []
+      |> List.sort (fun (_,n1) (_,n2) -> compare n2 n1)
+      |> List.take topn
+      |> List.map (fun (x, n) -> `Assoc [("var", `String (GobPretty.sprint Var.pretty_trace x)); ("updates", `Int n)])
+    in
+    let json = `Assoc ([
+        ("time", `Float time);
+        ("vars", `Int !SolverStats.vars);
+        ("evals", `Int !SolverStats.evals);
+        ("evals_per_sec", `Float (float_of_int (!SolverStats.evals - last_evals) /. max (time -. last_time) 1e-3));
+        ("destabilizations", `Int !SolverStats.destabilizations);
+        ("narrow_reuses", `Int !SolverStats.narrow_reuses);
+        ("heap_words", `Int gc.Gc.heap_words);
+        ("top_heap_words", `Int gc.Gc.top_heap_words);
+        ("hottest", `List hottest);
+      ] @ !solver_telemetry ())
+    in
+    Yojson.Safe.to_channel oc json;
+    output_char oc '\n';
+    flush oc
+
   (* print generic and specific stats *)
   let print_stats _ =
     Logs.newline ();
@@ -124,7 +174,8 @@ struct
     (* Gc.print_stat stdout; (* too verbose, slow and words instead of MB *) *)
     let gc = GobGc.print_quick_stat Legacy.stderr in
     Logs.newline ();
-    Option.may (write_csv [GobSys.string_of_time (); string_of_int !SolverStats.vars; string_of_int !SolverStats.evals; string_of_int !ncontexts; string_of_int gc.Gc.top_heap_words]) stats_csv
+    Option.may (write_csv [GobSys.string_of_time (); string_of_int !SolverStats.vars; string_of_int !SolverStats.evals; string_of_int !ncontexts; string_of_int gc.Gc.top_heap_words]) stats_csv;
+    Option.may write_telemetry telemetry
     (* print_string "Do you want to continue? [Y/n]"; *)
     (* flush stdout *)
     (* if read_line () = "n" then raise Break *)
@@ -133,7 +184,11 @@ struct
     let write_header = write_csv ["runtime"; "vars"; "evals"; "contexts"; "max_heap"] (* TODO @ !solver_stats_headers *) in
     Option.may write_header stats_csv;
     (* call print_stats on dbg.solver-signal *)
-    Sys.set_signal (GobSys.signal_of_string (get_string "dbg.solver-signal")) (Signal_handle print_stats);
+    let checkpoint_signal = get_bool "incremental.checkpoint.signal" in
+    Sys.set_signal (GobSys.signal_of_string (get_string "dbg.solver-signal")) (Signal_handle (fun s ->
+        print_stats s;
+        if checkpoint_signal then SolverCheckpoint.request ()
+      ));
     (* call print_stats every dbg.solver-stats-interval *)
     Sys.set_signal Sys.sigvtalrm (Signal_handle print_stats);
     (* https://ocaml.org/api/Unix.html#TYPEinterval_timer ITIMER_VIRTUAL is user time; sends sigvtalarm; ITIMER_PROF/sigprof is already used in Timeout.Unix.timeout *)
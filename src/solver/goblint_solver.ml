@@ -30,5 +30,8 @@ module PostSolver = PostSolver
 module LocalFixpoint = LocalFixpoint
 module SolverStats = SolverStats
 module SolverBox = SolverBox
+module SolverJournal = SolverJournal
+module SolverCheckpoint = SolverCheckpoint
+module SolverTrace = SolverTrace
 
 module SideWPointSelect = SideWPointSelect
@@ -323,7 +323,6 @@ module EqIncrSolverFromEqSolver (Sol: GenericEqSolver): GenericEqIncrSolver =
     module Post = MakeList (ListArgFromStdArg (S) (VH) (Arg))
 
     type marshal = unit
-    let copy_marshal () = ()
     let relift_marshal () = ()
 
     let solve xs vs _ =
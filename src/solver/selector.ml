@@ -24,11 +24,6 @@ module Make =
   struct
     type marshal = Obj.t (* cannot use Sol.marshal because cannot unpack first-class module in applicative functor *)
 
-    let copy_marshal (marshal: marshal) =
-      let module Sol = (val choose_solver (get_string "solver") : GenericEqIncrSolver) in
-      let module F = Sol (Arg) (S) (VH) in
-      Obj.repr (F.copy_marshal (Obj.obj marshal))
-
     let relift_marshal (marshal: marshal) =
       let module Sol = (val choose_solver (get_string "solver") : GenericEqIncrSolver) in
       let module F = Sol (Arg) (S) (VH) in
@@ -36,9 +31,19 @@ module Make =
 
     let solve xs vs (old_data: marshal option) =
       let module Sol = (val choose_solver (get_string "solver") : GenericEqIncrSolver) in
-      let module F = Sol (Arg) (S) (VH) in
-      let (vh, marshal) = F.solve xs vs (Option.map Obj.obj old_data) in
-      (vh, Obj.repr marshal)
+      let trace = get_string "dbg.solver-trace" in
+      if trace <> "" then (
+        let module R = SolverTrace.Record (S) (VH) in
+        let module F = Sol (Arg) (R) (VH) in
+        let (vh, marshal) = F.solve xs vs (Option.map Obj.obj old_data) in
+        R.write trace xs vs;
+        (vh, Obj.repr marshal)
+      )
+      else (
+        let module F = Sol (Arg) (S) (VH) in
+        let (vh, marshal) = F.solve xs vs (Option.map Obj.obj old_data) in
+        (vh, Obj.repr marshal)
+      )
   end
 
 let _ =
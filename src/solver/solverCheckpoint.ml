@@ -0,0 +1,100 @@
+(** Checkpoints of solver data for resuming long-running solves.
+
+    Checkpoints are requested asynchronously (periodically, by [dbg.solver-signal] or by a timeout), but only written by the solver at a safe point between evaluations of right-hand sides.
+    They are stored like incremental results in [incremental.save-dir], such that a following run with [--resume] continues solving from them via [incremental.load]. *)
+
+open Batteries
+
+(** Whether checkpointing is configured. *)
+let enabled () =
+  GobConfig.get_int "incremental.checkpoint.interval" > 0 || GobConfig.get_bool "incremental.checkpoint.signal" || GobConfig.get_int "incremental.checkpoint.abort-after" > 0
+
+(** Whether a solver which writes checkpoints is running. *)
+let running = ref false
+
+(** Whether a checkpoint has been requested. *)
+let requested = ref false
+
+(** Action to perform after the requested checkpoint, e.g. raising a timeout. *)
+let abort: (unit -> unit) option ref = ref None
+
+let interval = ref 0.
+let last = ref 0.
+
+(** Number of safe points passed in the current solve. *)
+let polls = ref 0
+
+(** Abort requested after a fixed number of safe points, see [incremental.checkpoint.abort-after]. *)
+let abort_after: (int * (unit -> unit)) option ref = ref None
+
+(** Stores the current state of the analyses as incremental analysis data.
+    Set by the caller of the solver, such that a resumed run initializes the analyses with their state at the checkpoint. *)
+let store_analysis_data: (unit -> unit) ref = ref (fun () -> ())
+
+(** Request a checkpoint at the next safe point.
+    Safe to call from signal handlers. *)
+let request () =
+  if !running then
+    requested := true
+
+(** Request a checkpoint at the next safe point, after which [f] is called to abort solving.
+    Returns [false] if no checkpointing solver is running or an abort is already pending, such that the caller should abort immediately. *)
+let request_abort f =
+  if !running && Option.is_none !abort then (
+    requested := true;
+    abort := Some f;
+    true
+  )
+  else
+    false
+
+(** Request a checkpoint at the [n]-th safe point, after which [f] is called to abort solving.
+    Deterministic replacement of a timeout for testing. *)
+let abort_at n f =
+  abort_after := if n > 0 then Some (n, f) else None
+
+(** Run a checkpointing solver.
+    An abort requested after the solver's last safe point is performed once the solver returns. *)
+let run f =
+  running := true;
+  requested := false;
+  abort := None;
+  interval := float_of_int (GobConfig.get_int "incremental.checkpoint.interval");
+  last := Unix.gettimeofday ();
+  polls := 0;
+  let pending = ref None in
+  let r = Fun.protect f ~finally:(fun () ->
+      running := false;
+      requested := false;
+      pending := !abort;
+      abort := None
+    )
+  in
+  Option.may (fun f -> f ()) !pending;
+  r
+
+(** Safe point of a checkpointing solver: calls [save] if a checkpoint is requested or the interval has passed. *)
+let poll save =
+  if !running then (
+    incr polls;
+    match !abort_after with
+    | Some (n, f) when !polls = n -> ignore (request_abort f)
+    | _ -> ()
+  );
+  if !running && (!requested || (!interval > 0. && Unix.gettimeofday () -. !last >= !interval)) then (
+    requested := false;
+    Timing.wrap "checkpoint" save ();
+    last := Unix.gettimeofday ();
+    match !abort with
+    | Some f ->
+      abort := None;
+      f ()
+    | None -> ()
+  )
+
+(** Store solver data together with the current analysis data as incremental data. *)
+let store (data: 'a) =
+  Logs.info "Writing solver checkpoint to %s" (Serialize.incremental_dirname Serialize.Save);
+  !store_analysis_data ();
+  Serialize.Cache.(update_data SolverData data);
+  Serialize.Cache.store_data ()
@@ -0,0 +1,147 @@
+(** Undo journal for mutations of solver hashtables.
+
+    In server mode, the solver data of the previous analysis is reused in place.
+    Instead of copying all tables before solving, the first mutation of each key in a tracked table records its old bindings,
+    such that all tables can be rolled back if solving is aborted (e.g. by [Sys.Break]). *)
+
+open Batteries
+
+type t = {
+  mutable undo: (unit -> unit) list; (** Restore old bindings, one per touched key of a tracked table. *)
+  mutable finish: (unit -> unit) list; (** Forget tracked tables. *)
+}
+
+let current: t option ref = ref None
+
+(** Whether a transaction is running. *)
+let is_active () = Option.is_some !current
+
+let finish j =
+  current := None;
+  List.iter (fun f -> f ()) j.finish
+
+(** Start a transaction.
+    Solvers track their tables with {!Make.track}. *)
+let start () =
+  assert (not (is_active ())); (* no nested transactions *)
+  current := Some {undo = []; finish = []}
+
+(** Keep all mutations since {!start}. *)
+let commit () =
+  Option.may finish !current
+
+(** Undo all mutations of tracked tables since {!start}. *)
+let rollback () =
+  match !current with
+  | Some j ->
+    finish j;
+    List.iter (fun f -> f ()) j.undo
+  | None -> ()
+
+(** [transaction f] runs [f] in a transaction, which is committed if [f] returns and rolled back if [f] raises. *)
+let transaction f =
+  start ();
+  match f () with
+  | r ->
+    commit ();
+    r
+  | exception e ->
+    let bt = Printexc.get_raw_backtrace () in
+    Logs.debug "Rolling back solver data";
+    rollback ();
+    Printexc.raise_with_backtrace e bt
+
+module Make (HM: Hashtbl.S) =
+struct
+  (** Tracked tables of the current transaction with their recorders.
+      Tables are compared by physical equality. *)
+  let tables: (Obj.t * (HM.key -> unit)) list ref = ref []
+
+  let find_recorder tbl =
+    let tbl = Obj.repr tbl in
+    let rec find = function
+      | [] -> None
+      | (tbl', record) :: tables -> if tbl == tbl' then Some record else find tables
+    in
+    find !tables
+
+  (** Track mutations of [tbl] in the current transaction, if any.
+      Must be called before the first mutation. *)
+  let track (tbl: 'a HM.t) =
+    match !current with
+    | Some j ->
+      if !tables = [] then
+        j.finish <- (fun () -> tables := []) :: j.finish;
+      let touched: unit HM.t = HM.create 113 in
+      let record k =
+        if not (HM.mem touched k) then (
+          HM.replace touched k ();
+          let old = HM.find_all tbl k in (* might have duplicate keys *)
+          j.undo <- (fun () ->
+              while HM.mem tbl k do
+                HM.remove tbl k
+              done;
+              List.iter (HM.add tbl k) (List.rev old)
+            ) :: j.undo
+        )
+      in
+      tables := (Obj.repr tbl, record) :: !tables
+    | None -> ()
+
+  let record tbl k =
+    match find_recorder tbl with
+    | Some record -> record k
+    | None -> ()
+
+  (** Hashtable operations, which record mutations of tracked tables.
+      Only mutations used by solvers are recorded. *)
+  module HM =
+  struct
+    include HM
+
+    let replace tbl k v =
+      record tbl k;
+      replace tbl k v
+
+    let add tbl k v =
+      record tbl k;
+      add tbl k v
+
+    let remove tbl k =
+      record tbl k;
+      remove tbl k
+
+    let record_all tbl =
+      match find_recorder tbl with
+      | Some record -> iter (fun k _ -> record k) tbl
+      | None -> ()
+
+    let clear tbl =
+      record_all tbl;
+      clear tbl
+
+    let reset tbl =
+      record_all tbl;
+      reset tbl
+
+    (* Record in the callback, such that [f] is only evaluated once per binding.
+       When a key is first recorded, its bindings are still unmodified, because the binding is only changed after [f] returns. *)
+    let filteri_inplace f tbl =
+      match find_recorder tbl with
+      | Some record -> filteri_inplace (fun k v -> f k v || (record k; false)) tbl
+      | None -> filteri_inplace f tbl
+
+    let filter_map_inplace f tbl =
+      match find_recorder tbl with
+      | Some record ->
+        filter_map_inplace (fun k v ->
+            let r = f k v in
+            begin match r with
+              | Some v' when v' == v -> ()
+              | _ -> record k
+            end;
+            r
+          ) tbl
+      | None -> filter_map_inplace f tbl
+  end
+end
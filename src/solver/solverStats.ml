@@ -3,6 +3,7 @@
 let vars = ref 0
 let evals = ref 0
 let narrow_reuses = ref 0
+let destabilizations = ref 0
 
 let print () =
   Logs.info "vars = %d    evals = %d    narrow_reuses = %d" !vars !evals !narrow_reuses
@@ -10,4 +11,5 @@ let print () =
 let reset () =
   vars := 0;
   evals := 0;
-  narrow_reuses := 0
+  narrow_reuses := 0;
+  destabilizations := 0
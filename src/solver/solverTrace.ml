@@ -0,0 +1,101 @@
+(** Traces of explored constraint systems for benchmarking solvers without analyses.
+
+    A trace records the right-hand side evaluations of a solver run: which variables they query and side-effect, in order.
+    Values are abstracted to versions: per variable, the join of all values recorded for it gets the next number whenever it grows, with [0] for bottom.
+    Versions thus form an ascending chain, also if contributions alternate.
+    Evaluations by the postsolver are not recorded.
+    Replaying a trace (see [bench/solverReplay]) re-runs solvers on a chain lattice of versions, where the [k]-th evaluation of a right-hand side repeats the [k]-th recorded one. *)
+
+open Batteries
+open ConstrSys
+
+type op =
+  | Get of int
+  | Side of int * int (** Variable and version of the side-effected value. *)
+
+type eval = {
+  ops: op array;
+  result: int; (** Version of the result. *)
+}
+
+type t = {
+  names: string array; (** [var_id]s of variables. *)
+  evals: eval array array; (** Evaluations of right-hand sides by variable, in order. Empty for variables without right-hand side. *)
+  start: (int * int) array; (** Start variables with versions of their values. *)
+  interesting: int array;
+}
+
+let load file: t =
+  File.with_file_in file (fun ic -> Marshal.input ic)
+
+let save file (trace: t) =
+  File.with_file_out file (fun oc -> Marshal.output oc trace)
+
+(** Record evaluations of right-hand sides of [S]. *)
+module Record (S: EqConstrSys) (VH: Hashtbl.S with type key = S.v) =
+struct
+  include S
+
+  let ids: int VH.t = VH.create 113
+  let names = DynArray.create ()
+  let evals: eval list DynArray.t = DynArray.create () (* reversed *)
+  let last: (S.d * int) option DynArray.t = DynArray.create () (* join of recorded values and its version *)
+
+  let id x =
+    match VH.find_option ids x with
+    | Some i -> i
+    | None ->
+      let i = VH.length ids in
+      VH.replace ids x i;
+      DynArray.add names (S.Var.var_id x);
+      DynArray.add evals [];
+      DynArray.add last None;
+      i
+
+  let version i d =
+    match DynArray.get last i with
+    | None when S.Dom.is_bot d -> 0
+    | None ->
+      DynArray.set last i (Some (d, 1));
+      1
+    | Some (acc, v) when d == acc || S.Dom.leq d acc -> v
+    | Some (acc, v) ->
+      DynArray.set last i (Some (S.Dom.join acc d, v + 1));
+      v + 1
+
+  let system x =
+    match S.system x with
+    | None -> None
+    | Some f when !AnalysisState.postsolving -> Some f
+    | Some f ->
+      Some (fun get set ->
+          let i = id x in
+          let ops = ref [] in
+          let get y =
+            ops := Get (id y) :: !ops;
+            get y
+          in
+          let set y d =
+            let j = id y in
+            ops := Side (j, version j d) :: !ops;
+            set y d
+          in
+          let d = f get set in
+          DynArray.set evals i ({ops = Array.of_list (List.rev !ops); result = version i d} :: DynArray.get evals i);
+          d
+        )
+
+  (** Write the trace of the system explored from start variables [xs] for [vs] to [file]. *)
+  let write file xs vs =
+    let start = Array.of_list (List.map (fun (x, d) -> let i = id x in (i, version i d)) xs) in
+    let interesting = Array.of_list (List.map id vs) in
+    let trace = {
+      names = DynArray.to_array names;
+      evals = Array.map (fun es -> Array.of_list (List.rev es)) (DynArray.to_array evals);
+      start;
+      interesting;
+    }
+    in
+    Logs.info "Writing constraint system trace of %d variables to %s" (Array.length trace.names) file;
+    save file trace
+end
@@ -51,6 +51,9 @@ module Base =
     module VS = Set.Make (S.Var)
     let exists_key f hm = HM.exists (fun k _ -> f k) hm
 
+    (** Raised by a query beyond the maximum nesting depth to abort the right-hand sides being evaluated until the queried variable is solved. *)
+    exception Unsolved
+
     type solver_data = {
       st: (S.Var.t * S.Dom.t) list; (* needed to destabilize start functions if their start state changed because of some changed global initializer *)
       infl: VS.t HM.t;
@@ -112,21 +115,6 @@ module Base =
         (* vice versa doesn't currently hold, because stable is not pruned *)
       )
 
-    let copy_marshal (data: marshal): marshal =
-      {
-        rho = HM.copy data.rho;
-        stable = HM.copy data.stable;
-        wpoint_gas = HM.copy data.wpoint_gas;
-        infl = HM.copy data.infl;
-        sides = HM.copy data.sides;
-        side_infl = HM.copy data.side_infl;
-        side_dep = HM.copy data.side_dep;
-        st = data.st; (* data.st is immutable *)
-        var_messages = HM.copy data.var_messages;
-        rho_write = HM.map (fun x w -> HM.copy w) data.rho_write; (* map copies outer HM *)
-        dep = HM.copy data.dep;
-      }
-
     (* The following hack is for fixing hashconsing.
        If hashcons is enabled now, then it also was for the loaded values (otherwise it would crash). If it is off, we don't need to do anything.
        HashconsLifter uses BatHashcons.hashcons on Lattice operations like join, so we call join (with bot) to make sure that the old values will populate the empty hashcons table via side-effects and at the same time get new tags that are conform with its state.
@@ -196,12 +184,29 @@ module Base =
     module CurrentVarS = ConstrSys.CurrentVarEqConstrSys (S)
     module S = CurrentVarS.S
 
+    (* Mutations of the solver data are journaled, such that an aborted solve (in server mode) can be rolled back. *)
+    module J = SolverJournal.Make (HM)
+    module HM = J.HM
+
+    let track_data data =
+      J.track data.infl;
+      J.track data.sides;
+      J.track data.rho;
+      J.track data.wpoint_gas;
+      J.track data.stable;
+      J.track data.side_dep;
+      J.track data.side_infl;
+      J.track data.var_messages;
+      J.track data.rho_write; (* inner tables are copied on write, see own_rho_write *)
+      J.track data.dep
+
     let solve st vs marshal =
       let reuse_stable = GobConfig.get_bool "incremental.stable" in
       let reuse_wpoint = GobConfig.get_bool "incremental.wpoint" in
       let data =
         match marshal with
         | Some data ->
+          track_data data;
           if not reuse_stable then (
             Logs.info "Destabilizing everything!";
             HM.clear data.stable;
@@ -219,9 +224,23 @@ module Base =
       let term  = GobConfig.get_bool "solvers.td3.term" in
       let default_side_widen_gas = GobConfig.get_int "solvers.td3.side_widen_gas" in
       let default_widen_gas = GobConfig.get_int "solvers.td3.widen_gas" in
+      let scc_wpoint = GobConfig.get_bool "solvers.td3.scc-wpoint" in
       let space = GobConfig.get_bool "solvers.td3.space" in
       let cache = GobConfig.get_bool "solvers.td3.space_cache" in
+      (* Space evaluates non-widening points without solve, so it cannot abort them. *)
+      let max_depth =
+        match GobConfig.get_int "solvers.td3.max-depth" with
+        | 0 when GobConfig.get_string "solver" = "td_stack" && not space -> 256
+        | n when n > 0 && not space -> n
+        | _ -> 0
+      in
+      let depth = ref 0 in (* number of right-hand sides being evaluated *)
+      let unsolved = ref None in (* variable whose query aborted the right-hand sides being evaluated *)
+      let pending = ref [] in (* variables whose right-hand sides were aborted, outermost first; they stay called until solved again *)
+      let aborted = ref 0 in
       let called = HM.create 10 in
+      (* Values of non-widening points are not kept with space, and aborted server solves are rolled back anyway. *)
+      let checkpoint = SolverCheckpoint.enabled () && not space && not (SolverJournal.is_active ()) && not (GobConfig.get_bool "solvers.td3.intern") && not (GobConfig.get_bool "solvers.td3.skip-unchanged-rhs") in (* interned checkpoint would lack the numbering, DepVals marshal would lack its dep_vals *)
 
       let infl = data.infl in
       let sides = data.sides in
@@ -253,6 +272,19 @@ module Base =
       let rho_write = data.rho_write in
       let dep = data.dep in
 
+      (* Inner tables of rho_write are not journaled, so copy them before the first mutation in a transaction. *)
+      let rho_write_owned = HM.create 10 in
+      let own_rho_write x w =
+        if SolverJournal.is_active () && not (HM.mem rho_write_owned x) then (
+          let w' = HM.copy w in
+          HM.replace rho_write x w';
+          HM.replace rho_write_owned x ();
+          w'
+        )
+        else
+          w
+      in
+
       let (module WPS) = SideWPointSelect.choose_impl () in
       let module WPS = struct
         include WPS (S) (HM) (VS)
@@ -261,8 +293,16 @@ module Base =
       let () = print_solver_stats := fun () ->
           print_data data;
           Logs.info "|called|=%d" (HM.length called);
+          if max_depth > 0 then Logs.debug "aborted evaluations: %d" !aborted;
           print_context_stats rho
       in
+      let () = solver_telemetry := fun () -> [
+            ("wpoints", `Int (HM.length wpoint_gas));
+            ("call_depth", `Int (HM.length called));
+            ("stable", `Int (HM.length stable));
+            ("contexts", context_telemetry rho);
+          ]
+      in
 
       if GobConfig.get_bool "incremental.load" then (
         print_data_verbose data "Loaded data for incremental analysis";
@@ -298,25 +338,68 @@ module Base =
           )
         | None -> ((* Not a widening point *)) in
       let should_widen x = HM.find_option wpoint_gas x = Some 0 in
+      (* Widen at the node of the widened unknown, because widening thresholds may depend on its function (see ana.int.interval_threshold_widening_scope). *)
+      let at_node x f =
+        let old_node = !Node.current_node in
+        let node = S.Var.node x in
+        Node.current_node := if Node.equal node (Function GoblintCil.dummyFunDec) then None else Some node; (* globals have no function *)
+        Fun.protect ~finally:(fun () -> Node.current_node := old_node) f
+      in
+      (* Loop heads in SCCs of the CFG (including nested ones), which would become wpoints once their cycle is detected during solving.
+         Computed per SCC on demand and cached for all its nodes. *)
+      let scc_heads = CfgTools.NH.create 113 in
+      let is_scc_head x =
+        let node = S.Var.node x in
+        match CfgTools.NH.find_option scc_heads node with
+        | Some head -> head
+        | None ->
+          match CfgTools.NH.find_option CfgTools.node_scc_global node with
+          | Some scc when CfgTools.NH.length scc.CfgTools.SCC.nodes > 1 ->
+            let heads = CfgTools.scc_loop_heads (module (val !MyCFG.current_cfg: MyCFG.CfgBidirSkip): MyCFG.CfgForward) scc in
+            CfgTools.NH.iter (fun n () -> CfgTools.NH.replace scc_heads n (CfgTools.NH.mem heads n)) scc.CfgTools.SCC.nodes;
+            CfgTools.NH.mem heads node
+          | _ -> false
+      in
       let wps_data = WPS.create_data (fun x -> HM.mem stable x) add_infl in
 
+      (* Called variables are marked stable before their rhs is evaluated, so they must be solved again when resuming. *)
+      let save_checkpoint () =
+        let called_vs = HM.fold (fun x () acc -> x :: acc) called [] in
+        List.iter (HM.remove stable) called_vs;
+        SolverCheckpoint.store {st; infl; sides; rho; wpoint_gas; stable; side_dep; side_infl; var_messages; rho_write; dep};
+        List.iter (fun x -> HM.replace stable x ()) called_vs
+      in
+
       (* Same as destabilize, but returns true if it destabilized a called var, or a var in vs which was stable. *)
-      let rec destabilize_vs x = (* TODO remove? Only used for side_widen cycle. *)
-        if tracing then trace "sol2" "destabilize_vs %a" S.Var.pretty_trace x;
-        let w = HM.find_default infl x VS.empty in
-        HM.replace infl x VS.empty;
-        VS.fold (fun y b ->
-            let was_stable = HM.mem stable y in
-            HM.remove stable y;
-            HM.remove superstable y;
-            Hooks.stable_remove y;
-            if not (HM.mem called y) then
-              destabilize_vs y || b || was_stable && List.mem_cmp S.Var.compare y vs
-            else
-              true
-          ) w false (* nosemgrep: fold-exists *) (* does side effects *)
-      and solve ?reuse_eq x phase =
+      let destabilize_vs x = (* TODO remove? Only used for side_widen cycle. *)
+        let todo = Stack.create () in
+        Stack.push x todo;
+        let b = ref false in
+        while not (Stack.is_empty todo) do
+          let x = Stack.pop todo in
+          if tracing then trace "sol2" "destabilize_vs %a" S.Var.pretty_trace x;
+          incr SolverStats.destabilizations;
+          let w = HM.find_default infl x VS.empty in
+          HM.replace infl x VS.empty;
+          VS.iter (fun y ->
+              let was_stable = HM.mem stable y in
+              HM.remove stable y;
+              HM.remove superstable y;
+              Hooks.stable_remove y;
+              if not (HM.mem called y) then (
+                if was_stable && List.mem_cmp S.Var.compare y vs then b := true;
+                Stack.push y todo
+              )
+              else
+                b := true
+            ) w
+        done;
+        !b
+      in
+
+      let rec solve ?reuse_eq x phase =
         if tracing then trace "sol2" "solve %a, phase: %s, called: %b, stable: %b, wpoint: %a" S.Var.pretty_trace x (show_phase phase) (HM.mem called x) (HM.mem stable x) pretty_wpoint x;
+        if checkpoint then SolverCheckpoint.poll save_checkpoint;
         init x;
         assert (Hooks.system x <> None);
         if not (HM.mem called x || HM.mem stable x) then (
@@ -340,7 +423,24 @@ module Base =
             | _ ->
               (* The RHS is re-evaluated, all deps are re-trigerred *)
               HM.replace dep x VS.empty;
-              eq x (eval l x) (side ~x)
+              if max_depth = 0 then
+                eq x (eval l x) (side ~x)
+              else (
+                let abort () =
+                  (* x is solved again from scratch once the queried variable is solved *)
+                  decr depth;
+                  pending := x :: !pending;
+                  HM.remove stable x;
+                  HM.remove superstable x;
+                  Hooks.stable_remove x;
+                  raise Unsolved
+                in
+                incr depth;
+                match eq x (eval l x) (side ~x) with
+                | _ when Option.is_some !unsolved -> abort () (* rhs caught Unsolved *)
+                | d -> decr depth; d
+                | exception Unsolved -> abort ()
+              )
           in
           HM.remove called x;
           let old = HM.find rho x in (* d from older solve *) (* find old value after eq since wpoint restarting in eq/eval might have changed it meanwhile *)
@@ -350,15 +450,16 @@ module Base =
 
           let wpd = (* d after widen/narrow (if wp) *)
             if not wp then eqd
-            else if term then
-              match phase with
-              | Widen -> S.Dom.widen old (S.Dom.join old eqd)
-              | Narrow when GobConfig.get_bool "exp.no-narrow" -> old (* no narrow *)
-              | Narrow ->
-                (* assert S.Dom.(leq eqd old || not (leq old eqd)); (* https://github.com/goblint/analyzer/pull/490#discussion_r875554284 *) *)
-                S.Dom.narrow old eqd
-            else
-              box old eqd
+            else at_node x @@ fun () ->
+              if term then
+                match phase with
+                | Widen -> S.Dom.widen old (S.Dom.join old eqd)
+                | Narrow when GobConfig.get_bool "exp.no-narrow" -> old (* no narrow *)
+                | Narrow ->
+                  (* assert S.Dom.(leq eqd old || not (leq old eqd)); (* https://github.com/goblint/analyzer/pull/490#discussion_r875554284 *) *)
+                  S.Dom.narrow old eqd
+              else
+                box old eqd
           in
           if tracing then trace "sol" "Var: %a (wp: %b)\nOld value: %a\nEqd: %a\nNew value: %a" S.Var.pretty_trace x wp S.Dom.pretty old S.Dom.pretty eqd S.Dom.pretty wpd;
           if cache then (
@@ -431,6 +532,11 @@ module Base =
           if tracing then trace "sol2" "eval adding wpoint %a from %a" S.Var.pretty_trace y S.Var.pretty_trace x;
           mark_wpoint y default_widen_gas;
         );
+        if max_depth > 0 && (Option.is_some !unsolved || !depth >= max_depth && Hooks.system y <> None && not (HM.mem called y || HM.mem stable y)) then (
+          if tracing then trace "sol2" "eval aborting %a ## %a" S.Var.pretty_trace x S.Var.pretty_trace y;
+          if Option.is_none !unsolved then unsolved := Some y;
+          raise Unsolved
+        );
         let tmp = simple_solve l x y in
         if HM.mem rho y then add_infl y x;
         if tracing then trace "sol2" "eval %a ## %a -> %a" S.Var.pretty_trace x S.Var.pretty_trace y S.Dom.pretty tmp;
@@ -441,13 +547,14 @@ module Base =
           Logs.warn "side-effect to unknown w/ rhs: %a, contrib: %a" S.Var.pretty_trace y S.Dom.pretty d;
         );
         assert (Hooks.system y = None);
+        if Option.is_some !unsolved then raise Unsolved; (* rhs caught Unsolved, its value is not to be trusted *)
         init y;
 
         WPS.notify_side wps_data x y;
 
         let widen a b =
           if M.tracing then M.traceli "sol2" "side widen %a %a" S.Dom.pretty a S.Dom.pretty b;
-          let r = S.Dom.widen a (S.Dom.join a b) in
+          let r = at_node y (fun () -> S.Dom.widen a (S.Dom.join a b)) in
           if M.tracing then M.traceu "sol2" "-> %a" S.Dom.pretty r;
           r
         in
@@ -490,7 +597,11 @@ module Base =
         if tracing then trace "sol2" "init %a" S.Var.pretty_trace x;
         if not (HM.mem rho x) then (
           new_var_event x;
-          HM.replace rho x (S.Dom.bot ())
+          HM.replace rho x (S.Dom.bot ());
+          if scc_wpoint && is_scc_head x then (
+            if tracing then trace "sol2" "init adding wpoint %a at SCC head" S.Var.pretty_trace x;
+            mark_wpoint x default_widen_gas
+          )
         )
       in
 
@@ -502,17 +613,46 @@ module Base =
         (* solve x Widen *)
       in
 
-      let rec destabilize_normal x =
-        if tracing then trace "sol2" "destabilize %a" S.Var.pretty_trace x;
-        let w = HM.find_default infl x VS.empty in
-        HM.replace infl x VS.empty;
-        VS.iter (fun y ->
-            if tracing then trace "sol2" "stable remove %a" S.Var.pretty_trace y;
-            HM.remove stable y;
-            HM.remove superstable y;
-            Hooks.stable_remove y;
-            if not (HM.mem called y) then destabilize_normal y
-          ) w
+      (* Solves x on an explicit stack of variables (only with max_depth).
+         When a query aborts, the queried variable is solved first, then the aborted variables from innermost to outermost, just like the native recursion would continue. *)
+      let solve_root x =
+        let rec loop = function
+          | [] -> ()
+          | y :: ys ->
+            HM.remove called y; (* if pending *)
+            match solve y Widen with
+            | () -> loop ys
+            | exception Unsolved ->
+              let z = Option.get !unsolved in
+              let stack = z :: List.rev_append !pending ys in
+              unsolved := None;
+              pending := [];
+              incr aborted;
+              loop stack
+        in
+        if max_depth = 0 then
+          solve x Widen
+        else
+          loop [x]
+      in
+
+      let destabilize_normal x =
+        let todo = Stack.create () in
+        Stack.push x todo;
+        while not (Stack.is_empty todo) do
+          let x = Stack.pop todo in
+          if tracing then trace "sol2" "destabilize %a" S.Var.pretty_trace x;
+          incr SolverStats.destabilizations;
+          let w = HM.find_default infl x VS.empty in
+          HM.replace infl x VS.empty;
+          VS.iter (fun y ->
+              if tracing then trace "sol2" "stable remove %a" S.Var.pretty_trace y;
+              HM.remove stable y;
+              HM.remove superstable y;
+              Hooks.stable_remove y;
+              if not (HM.mem called y) then Stack.push y todo
+            ) w
+        done
       in
 
       start_event ();
@@ -546,6 +686,7 @@ module Base =
         (* side_fuel specifies how many times (in recursion depth) to destabilize side_infl, None means infinite *)
         let rec destabilize_with_side ~side_fuel x =
           if tracing then trace "sol2" "destabilize_with_side %a %a" S.Var.pretty_trace x (Pretty.docOpt (Pretty.dprintf "%d")) side_fuel;
+          incr SolverStats.destabilizations;
 
           (* retrieve and remove (side-effect) dependencies/influences *)
           let w_side_dep = HM.find_default side_dep x VS.empty in
@@ -754,7 +895,11 @@ module Base =
             ) rho_write
         );
         delete_marked rho_write;
-        HM.iter (fun x w -> delete_marked w) rho_write;
+        HM.fold (fun x w acc -> (x, w) :: acc) rho_write [] (* own_rho_write may replace while iterating *)
+        |> List.iter (fun (x, w) ->
+            if List.exists (HM.mem w) sys_change.delete then
+              delete_marked (own_rho_write x w)
+          );
 
         print_data_verbose data "Data after clean-up";
 
@@ -766,7 +911,7 @@ module Base =
           HM.iter (fun x (old_rho, old_infl) -> HM.replace rho x old_rho; HM.replace infl x old_infl) old_ret;
           HM.iter (fun x (old_rho, old_infl) ->
               Logs.debug "test for %a" Node.pretty_trace (S.Var.node x);
-              solve x Widen;
+              solve_root x;
               if not (S.Dom.equal (HM.find rho x) old_rho) then (
                 Logs.debug "Further destabilization happened ...";
               )
@@ -798,11 +943,14 @@ module Base =
             Logs.newline ();
             flush_all ();
           );
-          List.iter (fun x -> solve x Widen) unstable_vs;
+          List.iter solve_root unstable_vs;
           solver ();
         )
       in
-      solver ();
+      if checkpoint then
+        SolverCheckpoint.run solver
+      else
+        solver ();
       (* Before we solved all unstable vars in rho with a rhs in a loop. This is unneeded overhead since it also solved unreachable vars (reachability only removes those from rho further down). *)
       (* After termination, only those variables are stable which are
        * - reachable from any of the queried variables vs, or
@@ -891,16 +1039,16 @@ module Base =
           filter_vs_hm side_dep;
           filter_vs_hm dep;
 
-          VH.filteri_inplace (fun x w ->
-              if VH.mem reachable x then (
+          VH.filteri_inplace (fun x _ ->
+              VH.mem reachable x
+            ) rho_write;
+          VH.fold (fun x w acc -> (x, w) :: acc) rho_write [] (* own_rho_write may replace while iterating *)
+          |> List.iter (fun (x, w) ->
+              if VH.exists (fun y _ -> not (VH.mem reachable y)) w then
                 VH.filteri_inplace (fun y _ ->
                     VH.mem reachable y
-                  ) w;
-                true
-              )
-              else
-                false
-            ) rho_write
+                  ) (own_rho_write x w)
+            )
 
         (* TODO: prune other data structures? *)
       end
@@ -1011,11 +1159,12 @@ module Base =
             (* Logs.debug "rho_write collect %a %a %a" S.Var.pretty_trace x S.Var.pretty_trace y S.Dom.pretty d; *)
             HM.replace stable y (); (* make stable just in case, so following incremental load would have in superstable *)
             let w =
-              try
-                VH.find rho_write x
-              with Not_found ->
+              match VH.find_option rho_write x with
+              | Some w -> own_rho_write x w
+              | None ->
                 let w = VH.create 1 in (* only create on demand, modify_def would eagerly allocate *)
                 VH.replace rho_write x w;
+                VH.replace rho_write_owned x ();
                 w
             in
             VH.add w y d (* intentional add *)
@@ -1099,10 +1248,12 @@ module DepVals: GenericEqIncrSolver =
     let current_dep_vals: dep_vals ref = ref (HM.create 0)
     (** Reference to current [dep_vals] in hooks. *)
 
+    module J = SolverJournal.Make (HM)
+
     module Hooks =
     struct
       module S = S
-      module HM = HM
+      module HM = J.HM (* journal dep_vals like Base data *)
 
       let print_data () =
         Logs.debug "|dep_vals|=%d" (HM.length !current_dep_vals)
@@ -1168,12 +1319,6 @@ module DepVals: GenericEqIncrSolver =
       dep_vals: dep_vals; (** Dependencies of variables and values encountered at last eval of RHS. *)
     }
 
-    let copy_marshal {base; dep_vals} =
-      {
-        base = Base.copy_marshal base;
-        dep_vals = HM.copy dep_vals;
-      }
-
     let relift_marshal {base; dep_vals} =
       let base' = Base.relift_marshal base in
       let dep_vals' = HM.create (HM.length dep_vals) in
@@ -1185,6 +1330,7 @@ module DepVals: GenericEqIncrSolver =
     let solve st vs marshal =
       let base_marshal = match marshal with
         | Some {base; dep_vals} ->
+          J.track dep_vals;
           current_dep_vals := dep_vals;
           Some base
         | None ->
@@ -1195,7 +1341,111 @@ module DepVals: GenericEqIncrSolver =
       (rho, {base = base_marshal'; dep_vals = !current_dep_vals})
   end
 
+(** TD3 with numbered variables ([solvers.td3.intern]).
+
+    Right-hand sides query and side-effect (node, context) pairs, which are numbered when TD3 encounters them for the first time.
+    All tables and sets of TD3 then hash and compare the numbers only.
+    Numbers are kept in the marshal, such that they stay the same across incremental runs. *)
+module Interned (Sol: GenericEqIncrSolver): GenericEqIncrSolver =
+  functor (Arg: IncrSolverArg) (S: EqConstrSys) (VH: Hashtbl.S with type key = S.v) ->
+  struct
+    (** Variable with its number. *)
+    module Var =
+    struct
+      type t = {
+        id: int;
+        var: S.v;
+      }
+
+      let equal x y = x.id = y.id
+      let hash x = x.id
+      let compare x y = Int.compare x.id y.id
+
+      let is_write_only x = S.Var.is_write_only x.var
+      let pretty_trace () x = S.Var.pretty_trace () x.var
+      let printXml f x = S.Var.printXml f x.var
+      let var_id x = S.Var.var_id x.var
+      let node x = S.Var.node x.var
+      let relift x = {x with var = S.Var.relift x.var}
+    end
+
+    let ids: Var.t VH.t ref = ref (VH.create 113)
+
+    let intern v =
+      try
+        VH.find !ids v
+      with Not_found ->
+        let x = {Var.id = VH.length !ids; var = v} in
+        VH.replace !ids v x;
+        x
+
+    module IS =
+    struct
+      type v = Var.t
+      type d = S.d
+      module Var = Var
+      module Dom = S.Dom
+
+      let get' get y = get (intern y)
+      let set' set y d = set (intern y) d
+
+      let system (x: v) =
+        match S.system x.var with
+        | None -> None
+        | Some f -> Some (fun get set -> f (get' get) (set' set))
+
+      let sys_change get =
+        let {obsolete; delete; reluctant; restart} = S.sys_change (get' get) in
+        let intern = List.map intern in
+        {obsolete = intern obsolete; delete = intern delete; reluctant = intern reluctant; restart = intern restart}
+    end
+
+    module IH = Hashtbl.Make (Var)
+
+    module Arg' =
+    struct
+      include Arg
+      let should_save_run = false (* saved below with original variables *)
+    end
+
+    module Sol' = Sol (Arg') (IS) (IH)
+
+    type marshal = Var.t VH.t * Sol'.marshal
+
+    let relift_marshal (ids, marshal) =
+      let ids' = VH.create (VH.length ids) in
+      VH.iter (fun v x -> VH.replace ids' (S.Var.relift v) (Var.relift x)) ids;
+      (ids', Sol'.relift_marshal marshal)
+
+    let solve st vs old_data =
+      ids := (match old_data with
+          | Some (ids, _) -> ids
+          | None -> VH.create 113
+        );
+      let st' = List.map (fun (v, d) -> (intern v, d)) st in
+      let vs' = List.map intern vs in
+      let (rho', marshal) = Sol'.solve st' vs' (Option.map snd old_data) in
+      let rho = VH.create (IH.length rho') in
+      IH.iter (fun x d -> VH.replace rho x.Var.var d) rho';
+      if Arg.should_save_run then (
+        let module SaveRun = PostSolver.SaveRun (S) (VH) in
+        SaveRun.finalize ~vh:rho ~reachable:(VH.create 0)
+      );
+      (rho, (!ids, marshal))
+  end
+
 let after_config () =
+  let intern = GobConfig.get_bool "solvers.td3.intern" in
+  let add_solver (name, (module Sol: GenericEqIncrSolver)) =
+    let add_solver name =
+      if intern then
+        Selector.add_solver (name, (module Interned (Sol): GenericEqIncrSolver))
+      else
+        Selector.add_solver (name, (module Sol: GenericEqIncrSolver))
+    in
+    add_solver name;
+    add_solver "td_stack" (* same solver, with solvers.td3.max-depth by default *)
+  in
   let restart_sided = GobConfig.get_bool "incremental.restart.sided.enabled" in
   let restart_wpoint = GobConfig.get_bool "solvers.td3.restart.wpoint.enabled" in
   let restart_once = GobConfig.get_bool "solvers.td3.restart.wpoint.once" in
@@ -1204,13 +1454,13 @@ let after_config () =
     if restart_sided || restart_wpoint || restart_once then (
       M.warn "restarting active, ignoring solvers.td3.skip-unchanged-rhs";
       (* TODO: fix DepVals with restarting, https://github.com/goblint/analyzer/pull/738#discussion_r876005821 *)
-      Selector.add_solver ("td3", (module Basic: GenericEqIncrSolver))
+      add_solver ("td3", (module Basic: GenericEqIncrSolver))
     )
     else
-      Selector.add_solver ("td3", (module DepVals: GenericEqIncrSolver))
+      add_solver ("td3", (module DepVals: GenericEqIncrSolver))
   )
   else
-    Selector.add_solver ("td3", (module Basic: GenericEqIncrSolver))
+    add_solver ("td3", (module Basic: GenericEqIncrSolver))
 
 let () =
   AfterConfig.register after_config
@@ -0,0 +1,61 @@
+(** In-memory cache of parsed translation units for reparsing in server mode.
+
+    A translation unit is only preprocessed and parsed again if its preprocessing command or a file, which it depends on according to its line markers (including the source file itself), has changed.
+    Unchanged translation units are still merged again, because the merged file is not modular. *)
+
+open Batteries
+
+module FpathH = Preprocessor.FpathH
+
+let enabled () = Serialize.server () && GobConfig.get_bool "server.reparse"
+
+type entry = {
+  key: string option; (** Key of the preprocessing task, see {!PreprocessorCache.key}. *)
+  digests: (string * Digest.t option) list; (** Absolute paths of dependencies with their digests. *)
+  dependencies: bool Fpath.Map.t; (** Dependencies recorded in {!Preprocessor.dependencies}. *)
+  ast: string; (** Marshaled, because merging and CFG construction modify the parsed file. *)
+}
+
+let entries: entry FpathH.t = FpathH.create 3
+
+(** Absolute paths of dependencies of translation units parsed in this run. *)
+let dependencies: Fpath.Set.t FpathH.t = FpathH.create 3
+
+let reused = ref 0
+
+let reset () =
+  FpathH.clear dependencies;
+  reused := 0
+
+(** Whether preprocessed [file] of [task] is unchanged since it was last parsed. *)
+let valid file task =
+  match FpathH.find_option entries file with
+  | Some entry -> entry.key = Option.map PreprocessorCache.key task && List.for_all (fun (path, d) -> PreprocessorCache.digest path = d) entry.digests
+  | None -> false
+
+(** Copy of the parsed preprocessed [file], which must be [valid]. *)
+let restore file =
+  let entry = FpathH.find entries file in
+  FpathH.replace Preprocessor.dependencies file entry.dependencies;
+  incr reused;
+  (Marshal.from_string entry.ast 0: GoblintCil.file)
+
+(** Record dependency [path] (absolute) of preprocessed [file]. *)
+let add_dependency file path =
+  FpathH.modify_def Fpath.Set.empty file (Fpath.Set.add path) dependencies
+
+(** Store parsed preprocessed [file] of [task].
+    Must be called before merging [ast]. *)
+let store file task (ast: GoblintCil.file) =
+  let digests = List.map (fun path -> let path = Fpath.to_string path in (path, PreprocessorCache.digest path)) (Fpath.Set.elements (FpathH.find_default dependencies file Fpath.Set.empty)) in
+  FpathH.replace entries file {
+    key = Option.map PreprocessorCache.key task;
+    digests;
+    dependencies = FpathH.find_default Preprocessor.dependencies file Fpath.Map.empty;
+    ast = Marshal.to_string ast [];
+  }
+
+(** Remove entries of translation units, which are not among [files] anymore. *)
+let retain files =
+  let files = Fpath.Set.of_list files in
+  FpathH.filteri_inplace (fun file _ -> Fpath.Set.mem file files) entries
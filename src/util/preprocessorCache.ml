@@ -0,0 +1,94 @@
+(** Persistent cache of preprocessed files.
+
+    Entries are keyed by the preprocessing command and its working directory.
+    An entry is only reused if no file, which the preprocessed file depends on according to its line markers (including the source file itself), has changed. *)
+
+open Batteries
+
+module FpathH = Preprocessor.FpathH
+
+let enabled () = GobConfig.get_bool "pre.cache"
+
+let dir () = Fpath.(GoblintDir.root () / "preprocessed-cache")
+
+(** Absolute paths of dependencies with their digests. *)
+type entry = (string * Digest.t) list
+
+let key (task: ProcessPool.task) =
+  Digest.to_hex (Digest.string (Marshal.to_string (task.command, Option.map Fpath.to_string task.cwd) []))
+
+(** Digests of dependencies in this run, shared between all preprocessed files. *)
+let digests: (string, Digest.t option) Hashtbl.t = Hashtbl.create 113
+
+let digest path =
+  match Hashtbl.find_option digests path with
+  | Some d -> d
+  | None ->
+    let d = try Some (Digest.file path) with Sys_error _ -> None in
+    Hashtbl.replace digests path d;
+    d
+
+(** Preprocessed files, which were not restored from the cache, with their tasks. *)
+let missed: ProcessPool.task FpathH.t = FpathH.create 3
+
+(** Absolute paths of dependencies of preprocessed files. *)
+let dependencies: Fpath.Set.t FpathH.t = FpathH.create 3
+
+let hits = ref 0
+
+let reset () =
+  Hashtbl.clear digests;
+  FpathH.clear missed;
+  FpathH.clear dependencies;
+  hits := 0
+
+let copy src dst =
+  let content = File.with_file_in (Fpath.to_string src) IO.read_all in
+  File.with_file_out (Fpath.to_string dst) (fun oc -> IO.nwrite oc content)
+
+(** Restore preprocessed [file] of [task] from the cache.
+    Returns [false] if [task] needs to be run. *)
+let restore file task =
+  let key = key task in
+  let entry_file = Fpath.(dir () / (key ^ ".deps")) in
+  let cached_file = Fpath.(dir () / (key ^ ".i")) in
+  let valid =
+    match File.with_file_in (Fpath.to_string entry_file) (fun ic -> (Marshal.input ic: entry)) with
+    | entry -> List.for_all (fun (path, d) -> digest path = Some d) entry && Sys.file_exists (Fpath.to_string cached_file)
+    | exception (Sys_error _ | End_of_file | IO.No_more_input | Failure _) -> false
+  in
+  if valid then (
+    Logs.Format.debug "Preprocessed %a restored from cache" Fpath.pp file;
+    copy cached_file file;
+    incr hits;
+    true
+  )
+  else (
+    FpathH.replace missed file task;
+    false
+  )
+
+(** Record dependency [path] (absolute) of preprocessed [file]. *)
+let add_dependency file path =
+  if FpathH.mem missed file then
+    FpathH.modify_def Fpath.Set.empty file (Fpath.Set.add path) dependencies
+
+(** Store preprocessed [file] in the cache, if it was not restored from it.
+    Must be called after parsing [file], such that its dependencies are recorded. *)
+let store file =
+  match FpathH.find_option missed file with
+  | Some task ->
+    let deps = Fpath.Set.elements (FpathH.find_default dependencies file Fpath.Set.empty) in
+    let entry = List.map (fun path -> let path = Fpath.to_string path in (path, digest path)) deps in
+    if entry <> [] && List.for_all (Option.is_some % snd) entry then ( (* without line markers, changes would go unnoticed *)
+      let entry: entry = List.map (Tuple2.map2 Option.get) entry in
+      let key = key task in
+      GobSys.mkdir_or_exists (dir ());
+      copy file Fpath.(dir () / (key ^ ".i"));
+      (* write entry last and atomically, such that an incomplete entry is never valid *)
+      let entry_file = Fpath.(dir () / (key ^ ".deps")) in
+      let tmp_file = Fpath.add_ext ".tmp" entry_file in
+      File.with_file_out (Fpath.to_string tmp_file) (fun oc -> Marshal.output oc entry);
+      Sys.rename (Fpath.to_string tmp_file) (Fpath.to_string entry_file)
+    )
+  | None -> ()
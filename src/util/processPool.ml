@@ -46,3 +46,61 @@ let run ~jobs ?(terminated=fun _ _ -> ()) tasks =
       run tasks
   in
   run tasks
+
+let rec waitpid pid =
+  try
+    ignore (Unix.waitpid [] pid)
+  with Unix.Unix_error (Unix.EINTR, _, _) -> (* interrupted by signal, e.g. solver stats *)
+    waitpid pid
+
+(** [fork_map ~jobs f xs] is [List.map f xs], but computed in up to [jobs] forked worker processes.
+    Workers see the memory of the parent at the time of the call, but their side effects are lost.
+    Results are returned to the parent by marshaling, so they should be small and must not contain closures.
+    If a worker fails, its part is computed in the parent instead. *)
+let fork_map ~jobs f xs =
+  let xs = Array.of_list xs in
+  let n = Array.length xs in
+  let jobs = min jobs n in
+  if jobs <= 1 then
+    List.map f (Array.to_list xs)
+  else (
+    let workers = List.init jobs (fun i ->
+        let js = List.init ((n - i + jobs - 1) / jobs) (fun k -> i + k * jobs) in (* round-robin for balance *)
+        let (fd_in, fd_out) = Unix.pipe ~cloexec:true () in
+        match Unix.fork () with
+        | 0 ->
+          Unix.close fd_in;
+          let code =
+            match List.map (fun j -> f xs.(j)) js with
+            | ys ->
+              let oc = Unix.out_channel_of_descr fd_out in
+              Marshal.to_channel oc ys [];
+              close_out oc;
+              0
+            | exception _ ->
+              1
+          in
+          Unix._exit code (* skip at_exit of parent, e.g. flushing its buffered output *)
+        | pid ->
+          Unix.close fd_out;
+          (pid, js, fd_in)
+      )
+    in
+    let results = Array.make n None in
+    List.iter (fun (pid, js, fd_in) ->
+        let ic = Unix.in_channel_of_descr fd_in in
+        let ys =
+          try Some (Marshal.from_channel ic) with
+          | End_of_file | Failure _ -> None
+        in
+        close_in ic;
+        waitpid pid;
+        match ys with
+        | Some ys ->
+          List.iter2 (fun j y -> results.(j) <- Some y) js ys
+        | None ->
+          Logs.warn "Worker process %d failed, computing its part sequentially" pid;
+          List.iter (fun j -> results.(j) <- Some (f xs.(j))) js
+      ) workers;
+    Array.to_list (Array.map Option.get results)
+  )
@@ -15,12 +15,30 @@ sig
   val find_cfg_node: string -> Arg.Node.t list
 end
 
+(** Results of the last completed analysis.
+    Used to answer read-only requests while another [analyze] is running and to restore the server state if it is aborted. *)
+type snapshot = {
+  snapshot_file: Cil.file option;
+  current_file: Cil.file;
+  current_cfg: (module MyCFG.CfgBidirSkip);
+  current_arg: (module ArgTools.BiArg) option;
+  messages_list: Messages.Message.t list; (** In reverse order, like {!Messages.Table.messages_list}. *)
+  node_state_json: Node.t -> Yojson.Safe.t option;
+  varquery_global_state_json: VarQuery.t option -> Yojson.Safe.t;
+  snapshot_arg_wrapper: (module ArgWrapper) ResettableLazy.t;
+}
+
 type t = {
   mutable file: Cil.file option;
   mutable max_ids: MaxIdUtil.max_ids;
   arg_wrapper: (module ArgWrapper) ResettableLazy.t;
   invariant_parser: InvariantParser.t ResettableLazy.t;
   input: IO.input;
+  mutable input_fd: Unix.file_descr option; (** For polling [input] during [analyze], [None] after end of input. *)
+  lexbuf: Lexing.lexbuf;
+  mutable packets: Packet.t Seq.t;
+  deferred: Packet.t Queue.t; (** Packets received during [analyze], which are handled after it. *)
+  mutable snapshot: snapshot option;
   output: unit IO.output;
 }
 
@@ -44,6 +62,9 @@ end
 
 let registry = Registry.make ()
 
+(** Names of read-only requests, which are answered from the {!snapshot} during a running [analyze]. *)
+let snapshot_requests: (string, unit) Hashtbl.t = Hashtbl.create 16
+
 module ParamParser (R : Request) = struct
   let parse params =
     let maybe_params =
@@ -73,20 +94,20 @@ module Function = struct
   let getFunctionsList files = List.filter_map filterFunctions files
 end
 
-let handle_request (serv: t) (request: Request.t): Response.t =
+let handle_request ?(stats=true) (serv: t) (request: Request.t): Response.t =
   match Hashtbl.find_option registry request.method_ with
   | Some (module R) ->
     let module Parser = ParamParser (R) in
     begin match Parser.parse request.params with
       | Ok params ->
         begin try
-            Maingoblint.reset_stats ();
+            if stats then Maingoblint.reset_stats ();
             let r =
               R.process params serv
               |> R.response_to_yojson
               |> Response.ok request.id
             in
-            Maingoblint.do_stats ();
+            if stats then Maingoblint.do_stats ();
             r
           with Response.Error.E error ->
             Response.error request.id error
@@ -97,6 +118,10 @@ let handle_request (serv: t) (request: Request.t): Response.t =
   | _ ->
     Response.(Error.make ~code:MethodNotFound ~message:request.method_ () |> error request.id)
 
+let write_packet (serv: t) (packet: Packet.t) =
+  Packet.yojson_of_t packet |> Yojson.Safe.to_string |> IO.write_line serv.output;
+  IO.flush serv.output
+
 let handle_packet (serv: t) (packet: Packet.t) =
   let response_packet: Packet.t option = match packet with
     | Request request -> Some (Response (handle_request serv request))
@@ -108,18 +133,42 @@ let handle_packet (serv: t) (packet: Packet.t) =
       Some (Batch_response responses)
     | _ -> None (* ignore others for now *)
   in
-  match response_packet with
-  | Some response_packet ->
-    Packet.yojson_of_t response_packet |> Yojson.Safe.to_string |> IO.write_line serv.output;
-    IO.flush serv.output
-  | None -> ()
+  Option.may (write_packet serv) response_packet
+
+let read_packet (serv: t) =
+  match serv.packets () with
+  | Seq.Cons (packet, packets) ->
+    serv.packets <- packets;
+    Some packet
+  | Seq.Nil ->
+    serv.input_fd <- None;
+    None
+
+(** Whether a packet can be read without waiting for the client.
+    Packets already read into the channel buffer are not detected, so these are only handled after a running [analyze]. *)
+let input_ready (serv: t) =
+  let lexbuf = serv.lexbuf in
+  let rec buffered i =
+    i < lexbuf.lex_buffer_len && match Bytes.get lexbuf.lex_buffer i with
+    | ' ' | '\t' | '\r' | '\n' -> buffered (i + 1)
+    | _ -> true
+  in
+  buffered lexbuf.lex_curr_pos || match serv.input_fd with
+  | Some fd ->
+    let readable, _, _ = Unix.select [fd] [] [] 0.0 in
+    readable <> []
+  | None -> false
 
 let serve serv =
-  serv.input
-  |> Lexing.from_channel
-  |> Yojson.Safe.seq_from_lexbuf (Yojson.init_lexer ())
-  |> Seq.map Packet.t_of_yojson
-  |> Seq.iter (handle_packet serv)
+  let rec loop () =
+    let packet = if Queue.is_empty serv.deferred then read_packet serv else Some (Queue.pop serv.deferred) in
+    match packet with
+    | Some packet ->
+      handle_packet serv packet;
+      loop ()
+    | None -> ()
+  in
+  loop ()
 
 (** Is node valid for lookup by location?
     Used for abstract debugging breakpoints. *)
@@ -127,7 +176,7 @@ let is_server_node cfgnode =
   let loc = UpdateCil.getLoc cfgnode in
   not loc.synthetic
 
-let arg_wrapper: (module ArgWrapper) ResettableLazy.t =
+let make_arg_wrapper (): (module ArgWrapper) ResettableLazy.t =
   ResettableLazy.from_fun (fun () ->
       let module Arg = (val (Option.get_exn !ArgTools.current_arg Response.Error.(E (make ~code:RequestFailed ~message:"not analyzed or arg disabled" ())))) in
       let module Locator = WitnessUtil.Locator (Arg.Node) in
@@ -157,23 +206,36 @@ let arg_wrapper: (module ArgWrapper) ResettableLazy.t =
       (module ArgWrapper: ArgWrapper)
     )
 
+let arg_wrapper = make_arg_wrapper ()
+
 let invariant_parser: InvariantParser.t ResettableLazy.t =
   ResettableLazy.from_fun (fun () ->
       InvariantParser.create !Cilfacade.current_file
     )
 
-let make ?(input=stdin) ?(output=stdout) file : t =
+let make ?(input=stdin) ?input_fd ?(output=stdout) file : t =
   let max_ids =
     match file with
     | Some file -> MaxIdUtil.get_file_max_ids file
     | None -> MaxIdUtil.get_file_max_ids Cil.dummyFile (* TODO: avoid this altogether *)
   in
+  let lexbuf = Lexing.from_channel input in
+  let packets =
+    lexbuf
+    |> Yojson.Safe.seq_from_lexbuf (Yojson.init_lexer ())
+    |> Seq.map Packet.t_of_yojson
+  in
   {
     file;
     max_ids;
     arg_wrapper;
     invariant_parser;
     input;
+    input_fd;
+    lexbuf;
+    packets;
+    deferred = Queue.create ();
+    snapshot = None;
     output
   }
 
@@ -181,7 +243,7 @@ let bind () =
   match GobConfig.get_string "server.mode" with
   | "stdio" ->
     Logs.Result.use_stdout := false;
-    (None, None)
+    (None, Some Unix.stdin, None)
   | "unix" ->
     let path = GobConfig.get_string "server.unix-socket" in
     if Sys.file_exists path then
@@ -192,14 +254,14 @@ let bind () =
     let conn, _ = Unix.accept socket in
     Unix.close socket;
     Sys.remove path;
-    (Some (Unix.input_of_descr conn), Some (Unix.output_of_descr conn))
+    (Some (Unix.input_of_descr conn), Some conn, Some (Unix.output_of_descr conn))
   | _ -> assert false
 
 let start file =
-  let input, output = bind () in
+  let input, input_fd, output = bind () in
   GobConfig.set_bool "incremental.save" true;
   Maingoblint.do_stats (); (* print pre-server stats just in case *)
-  serve (make file ?input ?output)
+  serve (make file ?input ?input_fd ?output)
 
 let reparse (s: t) =
   if GobConfig.get_bool "server.reparse" then (
@@ -217,25 +279,57 @@ let reparse (s: t) =
   else
     (Option.get s.file, false)
 
+(** Additionally consider functions satisfying [reanalyze] changed, such that they are reanalyzed. *)
+let force_reanalyze reanalyze (changes: CompareCIL.change_info) =
+  let forced, unchanged = List.partition (fun ({current; _}: CompareCIL.unchanged_global) ->
+      match current.def with
+      | Some (Fun _) -> reanalyze current
+      | _ -> false
+    ) changes.unchanged
+  in
+  changes.unchanged <- unchanged;
+  List.iter (fun ({old; current}: CompareCIL.unchanged_global) ->
+      match current.def with
+      | Some (Fun fdec) ->
+        changes.exclude_from_rel_destab <- CompareCIL.VarinfoSet.add fdec.svar changes.exclude_from_rel_destab;
+        changes.changed <- {old; current; unchangedHeader = false; diff = None} :: changes.changed
+      | _ -> ()
+    ) forced;
+  changes
+
 (* Only called when the file has not been reparsed, so we can skip the expensive CFG comparison. *)
-let virtual_changes file =
-  let eq ?(matchVars=true) ?(matchFuns=true) ?(renameDetection=false) _ _ _ gc_old (gc_new: CompareCIL.global_col) ((change_info : CompareCIL.change_info), final_matches) = (match gc_new.def with
-      | Some (Fun fdec) when CompareCIL.should_reanalyze fdec ->
-        change_info.exclude_from_rel_destab <- CompareCIL.VarinfoSet.add fdec.svar change_info.exclude_from_rel_destab
-      | _ -> change_info.unchanged <- {old = gc_old; current= gc_new} :: change_info.unchanged);
-    change_info, final_matches
+let virtual_changes ?(reanalyze=fun _ -> false) file =
+  let reanalyze (gc: CompareCIL.global_col) =
+    reanalyze gc || match gc.def with
+    | Some (Fun fdec) -> CompareCIL.should_reanalyze fdec
+    | _ -> false
+  in
+  (* like eq_glob, every global is only handled in the pass for its kind *)
+  let eq ?(matchVars=true) ?(matchFuns=true) ?renameDetection _ _ _ gc_old (gc_new: CompareCIL.global_col) ((change_info : CompareCIL.change_info), final_matches) =
+    let is_kind = match gc_new.def with
+      | Some (Fun _) -> matchFuns
+      | Some (Var _) | None -> matchVars
+    in
+    if is_kind then (
+      change_info.unchanged <- {old = gc_old; current = gc_new} :: change_info.unchanged;
+      change_info, CompareCIL.addToFinalMatchesMapping (CompareCIL.get_varinfo gc_old) (CompareCIL.get_varinfo gc_new) final_matches
+    )
+    else
+      change_info, final_matches
   in
-  CompareCIL.compareCilFiles ~eq file file
+  force_reanalyze reanalyze (CompareCIL.compareCilFiles ~eq ~compare_cfgs:false file file)
 
-let increment_data (s: t) file reparsed = match Serialize.Cache.get_opt_data SolverData with
+(** Functions satisfying [reanalyze] were reported by the client, so they are reanalyzed even if unchanged. *)
+let increment_data ?reanalyze (s: t) file reparsed = match Serialize.Cache.get_opt_data SolverData with
   | Some solver_data when reparsed ->
     let s_file = Option.get s.file in
     let changes = CompareCIL.compareCilFiles s_file file in
+    let changes = Option.map_default force_reanalyze Fun.id reanalyze changes in
     s.max_ids <- UpdateCil.update_ids s_file s.max_ids file changes;
     (* TODO: get globals for restarting from config *)
     Some { server = true; Analyses.changes; solver_data; restarting = [] }, false
   | Some solver_data ->
-    let changes = virtual_changes file in
+    let changes = virtual_changes ?reanalyze file in
     (* TODO: get globals for restarting from config *)
     Some { server = true; Analyses.changes; solver_data; restarting = [] }, false
   | _ -> None, true
@@ -272,54 +366,162 @@ let node_locator: Locator.t ResettableLazy.t =
       locator
     )
 
-let analyze ?(reset=false) (s: t) =
-  Messages.Table.(MH.clear messages_table);
+module Snapshot =
+struct
+  let take (s: t): snapshot = {
+    snapshot_file = s.file;
+    current_file = !Cilfacade.current_file;
+    current_cfg = !MyCFG.current_cfg;
+    current_arg = !ArgTools.current_arg;
+    messages_list = !Messages.Table.messages_list;
+    node_state_json = !Control.current_node_state_json;
+    varquery_global_state_json = !Control.current_varquery_global_state_json;
+    snapshot_arg_wrapper = make_arg_wrapper ();
+  }
+
+  let set (s: t) (snapshot: snapshot) =
+    s.file <- snapshot.snapshot_file;
+    Cilfacade.current_file := snapshot.current_file;
+    MyCFG.current_cfg := snapshot.current_cfg;
+    ArgTools.current_arg := snapshot.current_arg;
+    Messages.Table.messages_list := snapshot.messages_list;
+    Control.current_node_state_json := snapshot.node_state_json;
+    Control.current_varquery_global_state_json := snapshot.varquery_global_state_json
+
+  (** Run [f] with the results of [snapshot] instead of the running analysis.
+      Lazy maps of the file are reset on entry and exit, such that neither side sees maps built for the other's file. *)
+  let with_snapshot (s: t) (snapshot: snapshot) f =
+    let current = take s in
+    let reset_lazy () =
+      Cilfacade.reset_lazy_maps ();
+      ResettableLazy.reset node_locator
+    in
+    set s snapshot;
+    reset_lazy ();
+    Fun.protect ~finally:(fun () -> set s current; reset_lazy ()) f
+
+  (** Restore the server state of [snapshot] after an aborted analysis. *)
+  let restore (s: t) (snapshot: snapshot) =
+    set s snapshot;
+    Messages.Table.clear ();
+    Messages.Table.messages_list := snapshot.messages_list;
+    List.iter (fun m -> Messages.Table.(MH.replace messages_table m ())) snapshot.messages_list;
+    Cilfacade.reset_lazy ();
+    ResettableLazy.reset node_locator;
+    ResettableLazy.reset s.arg_wrapper;
+    ResettableLazy.reset s.invariant_parser
+end
+
+(** Handle a packet received during [analyze].
+    Read-only requests are answered from the last completed analysis, a new [analyze] cancels the running one
+    and all other packets are deferred until [analyze] returns. *)
+let handle_concurrent_packet ~cancel (s: t) (packet: Packet.t) =
+  match packet, s.snapshot with
+  | Request request, Some snapshot when Hashtbl.mem snapshot_requests request.method_ ->
+    let response = Snapshot.with_snapshot s snapshot (fun () ->
+        handle_request ~stats:false {s with arg_wrapper = snapshot.snapshot_arg_wrapper} request
+      )
+    in
+    write_packet s (Response response)
+  | Request {method_ = "analyze"; _}, _ when Goblint_solver.SolverJournal.is_active () -> (* solver data can be rolled back *)
+    Queue.push packet s.deferred;
+    cancel ()
+  | _, _ ->
+    Queue.push packet s.deferred
+
+(** Poll for packets every 256 right-hand side evaluations of the solver.
+    With [dbg.test.server-await-request], the first poll blocks until a packet arrives. *)
+let poll ~cancel (s: t) =
+  let evals = ref 0 in
+  let await = ref (GobConfig.get_bool "dbg.test.server-await-request" && Option.is_some s.snapshot) in
+  fun () ->
+    incr evals;
+    if !await then (
+      await := false;
+      Option.may (handle_concurrent_packet ~cancel s) (read_packet s)
+    )
+    else if !evals land 0xff = 0 && input_ready s then
+      Option.may (handle_concurrent_packet ~cancel s) (read_packet s)
+
+let analyze ?(reset=false) ?reanalyze (s: t) =
+  let before = Snapshot.take s in
+  Messages.Table.clear ();
   Messages.(Table.MH.clear final_table);
-  Messages.Table.messages_list := [];
   let file, reparsed = reparse s in
   if reset then (
     let max_ids = MaxIdUtil.get_file_max_ids file in
     s.max_ids <- max_ids;
     Serialize.Cache.reset_data SolverData;
     Serialize.Cache.reset_data AnalysisData);
-  let increment_data, fresh = increment_data s file reparsed in
+  let increment_data, fresh = increment_data ?reanalyze s file reparsed in
+  if fresh && GobConfig.get_string "ana.base.addresses.domain" = "bitset" then
+    s.snapshot <- None; (* its results refer to interned addresses, which are reset *)
   ResettableLazy.reset node_locator;
   ResettableLazy.reset s.arg_wrapper;
-  ResettableLazy.reset s.invariant_parser;
-  Cilfacade.reset_lazy ();
+  (* these only depend on the file *)
+  if reparsed then (
+    ResettableLazy.reset s.invariant_parser;
+    AutoTune.reset_lazy ()
+  );
+  Cilfacade.reset_lazy ~keep_maps:(not reparsed) ();
   InvariantCil.reset_lazy ();
   WideningThresholds.reset_lazy ();
   IntDomain.reset_lazy ();
   FloatDomain.reset_lazy ();
   StringDomain.reset_lazy ();
+  AddressDomain.reset_lazy ();
   PrecisionUtil.reset_lazy ();
   ApronDomain.reset_lazy ();
-  AutoTune.reset_lazy ();
   LibraryFunctions.reset_lazy ();
   Access.reset ();
   s.file <- Some file;
   GobConfig.set_bool "incremental.load" (not fresh);
+  let cancelled = ref false in
+  AnalysisState.poll := poll s ~cancel:(fun () ->
+      cancelled := true;
+      raise Sys.Break
+    );
   Fun.protect ~finally:(fun () ->
-      GobConfig.set_bool "incremental.load" true
+      GobConfig.set_bool "incremental.load" true;
+      AnalysisState.poll := ignore
     ) (fun () ->
-      Maingoblint.do_analyze increment_data (Option.get s.file);
-      Maingoblint.do_gobview (Option.get s.file);
+      try
+        Maingoblint.do_analyze increment_data (Option.get s.file);
+        Maingoblint.do_gobview (Option.get s.file);
+        s.snapshot <- Some (Snapshot.take s)
+      with Sys.Break when !cancelled ->
+        (* solver data was rolled back, so also go back to the file and results it belongs to *)
+        Snapshot.restore s before;
+        raise Sys.Break
     )
 
 let () =
   let register = Registry.register registry in
+  let register_snapshot (module R: Request) =
+    Hashtbl.replace snapshot_requests R.name ();
+    register (module R)
+  in
 
   register (module struct
     let name = "analyze"
-    type params = { reset: bool [@default false] } [@@deriving of_yojson]
+    type params = {
+      reset: bool [@default false];
+      functions: string list [@default []]; (** Names of functions to reanalyze, even if they are unchanged. *)
+    } [@@deriving of_yojson]
     (* TODO: Return analysis results as JSON. Useful for GobPie. *)
     type status = Success | VerifyError | Aborted [@@deriving to_yojson]
     type response = { status: status } [@@deriving to_yojson]
     (* TODO: Add options to control the analysis precision/context for specific functions. *)
-    (* TODO: Add option to mark functions as modified. *)
-    let process { reset } serve =
+    let process { reset; functions } serve =
+      let reanalyze =
+        match functions with
+        | [] -> None
+        | _ ->
+          let functions = Set.String.of_list functions in
+          Some (fun (gc: CompareCIL.global_col) -> Set.String.mem (CompareCIL.name_of_global_col gc) functions)
+      in
       try
-        analyze serve ~reset;
+        analyze serve ~reset ?reanalyze;
         (* TODO: generalize VerifyError for AnalysisState.unsound_both_branches_dead *)
         {status = if !AnalysisState.verified = Some false then VerifyError else Success}
       with
@@ -379,7 +581,7 @@ let () =
         Response.Error.(raise (of_exn exn))
   end);
 
-  register (module struct
+  register_snapshot (module struct
     let name = "messages"
     type params = unit [@@deriving of_yojson]
     type response = Messages.Message.t list [@@deriving to_yojson]
@@ -410,7 +612,7 @@ let () =
         Response.Error.(raise (make ~code:RequestFailed ~message ()))
   end);
 
-  register (module struct
+  register_snapshot (module struct
     let name = "functions"
     type params = unit [@@deriving of_yojson]
     type response = Function.t list [@@deriving to_yojson]
@@ -547,7 +749,7 @@ let () =
       {node = node_id; location; function_; next; prev}
   end);
 
-  register (module struct
+  register_snapshot (module struct
     let name = "arg/dot"
     type params = unit [@@deriving of_yojson]
     type response = {
@@ -566,7 +768,7 @@ let () =
       {arg}
   end);
 
-  register (module struct
+  register_snapshot (module struct
     let name = "arg/lookup"
     type params = {
       node: string option [@default None];
@@ -665,7 +867,7 @@ let () =
       }
   end);
 
-  register (module struct
+  register_snapshot (module struct
     let name = "node_state"
     type params = { nid: string }  [@@deriving of_yojson]
     type response = Yojson.Safe.t [@@deriving to_yojson]
@@ -679,7 +881,7 @@ let () =
       | exception Not_found -> Response.Error.(raise (make ~code:RequestFailed ~message:"not analyzed or non-existent node" ()))
   end);
 
-  register (module struct
+  register_snapshot (module struct
     let name = "global-state"
     type params = {
       vid: int option [@default None];
@@ -706,7 +908,7 @@ let () =
       !Control.current_varquery_global_state_json vq_opt
   end);
 
-  register (module struct
+  register_snapshot (module struct
     let name = "arg/state"
     type params = {
       node: string
@@ -814,7 +1016,7 @@ let () =
       !ExpressionEvaluation.gv_results
   end);
 
-  register (module struct
+  register_snapshot (module struct
     let name = "ping"
     type params = unit [@@deriving of_yojson]
     type response = [`Pong] [@@deriving to_yojson]
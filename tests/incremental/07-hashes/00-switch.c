@@ -0,0 +1,20 @@
+#include <goblint.h>
+
+enum kind { A, B, C };
+
+int sw(enum kind k) {
+  switch (k) {
+    case A:
+      return 1;
+    case B:
+      return 2;
+    default:
+      return 0;
+  }
+}
+
+int main() {
+  int r = sw(B);
+  __goblint_check(r == 2);
+  return 0;
+}
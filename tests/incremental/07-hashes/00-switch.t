@@ -0,0 +1,17 @@
+Run Goblint on initial program version
+
+  $ goblint --conf 00-switch.json --enable incremental.save 00-switch.c > /dev/null 2>&1
+
+Apply patch, which moves the enum used by the cases of the switch in the unchanged function
+
+  $ chmod +w 00-switch.c
+  $ patch -b <00-switch.patch
+  patching file 00-switch.c
+
+Run Goblint incrementally on new program version and check that the function with the switch is matched by its hash
+
+  $ goblint --conf 00-switch.json --enable incremental.load --set dbg.level debug 00-switch.c 2>&1 | grep 'Unchanged by hash: sw$'
+  [Debug] Unchanged by hash: sw
+
+  $ goblint --conf 00-switch.json --enable incremental.load 00-switch.c 2>&1 | grep 'change_info' | sed -r 's/change_info = \{ unchanged = [[:digit:]]+; (.*) \}$/\1/'
+  [Info] changed = 1 (with unchangedHeader = 1); added = 1; removed = 0
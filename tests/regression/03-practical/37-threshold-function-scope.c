@@ -0,0 +1,29 @@
+// PARAM: --enable ana.int.interval --enable ana.int.interval_threshold_widening --set ana.int.interval_threshold_widening_constants all --set ana.int.interval_threshold_widening_scope function
+#include <goblint.h>
+#include <stdlib.h>
+
+int bounded_by_arg(int n) {
+  int i = 0;
+  while (rand()) {
+    if (i < n) // narrowing cannot recover the bound, only a threshold can
+      i++;
+  }
+  return i;
+}
+
+int bounded_by_own(void) {
+  int j = 0;
+  while (rand()) {
+    if (j < 30)
+      j++;
+  }
+  return j;
+}
+
+int main() {
+  int i = bounded_by_arg(50);
+  __goblint_check(i <= 50); // UNKNOWN! 50 is only a constant of main, but with program scope this holds
+  int j = bounded_by_own();
+  __goblint_check(j <= 30); // 30 is a constant of bounded_by_own
+  return 0;
+}
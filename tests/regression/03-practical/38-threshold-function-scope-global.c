@@ -0,0 +1,32 @@
+// PARAM: --enable ana.int.interval --enable ana.int.interval_threshold_widening --set ana.int.interval_threshold_widening_constants all --set ana.int.interval_threshold_widening_scope function
+#include <pthread.h>
+#include <goblint.h>
+#include <stdlib.h>
+
+int g = 0;
+pthread_mutex_t m = PTHREAD_MUTEX_INITIALIZER;
+
+void inc_unlock(void) {
+  g++; // side effect to g from a function without thresholds
+  pthread_mutex_unlock(&m);
+}
+
+void *t_fun(void *arg) {
+  while (rand()) {
+    pthread_mutex_lock(&m);
+    if (g < 40)
+      inc_unlock();
+    else
+      pthread_mutex_unlock(&m);
+  }
+  return NULL;
+}
+
+int main() {
+  pthread_t id;
+  pthread_create(&id, NULL, t_fun, NULL);
+  pthread_mutex_lock(&m);
+  __goblint_check(g <= 40); // globals are widened with thresholds of the whole program
+  pthread_mutex_unlock(&m);
+  return 0;
+}
@@ -0,0 +1,37 @@
+// PARAM: --set jobs 2
+// Race checking of memory locations is split across worker processes.
+#include <pthread.h>
+#include <stdio.h>
+
+int myglobal;
+int safe;
+struct s {
+  int a;
+  int b;
+} s;
+pthread_mutex_t mutex1 = PTHREAD_MUTEX_INITIALIZER;
+pthread_mutex_t mutex2 = PTHREAD_MUTEX_INITIALIZER;
+
+void *t_fun(void *arg) {
+  pthread_mutex_lock(&mutex1);
+  myglobal=myglobal+1; // RACE!
+  safe=safe+1; // NORACE
+  s.a = 1; // RACE!
+  pthread_mutex_unlock(&mutex1);
+  s.b = 1; // NORACE
+  return NULL;
+}
+
+int main(void) {
+  pthread_t id;
+  pthread_create(&id, NULL, t_fun, NULL);
+  pthread_mutex_lock(&mutex2);
+  myglobal=myglobal+1; // RACE!
+  pthread_mutex_unlock(&mutex2);
+  pthread_mutex_lock(&mutex1);
+  safe=safe+1; // NORACE
+  pthread_mutex_unlock(&mutex1);
+  s.a = 2; // RACE!
+  pthread_join (id, NULL);
+  return 0;
+}
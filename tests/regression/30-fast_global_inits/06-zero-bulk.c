@@ -0,0 +1,29 @@
+// PARAM: --enable ana.int.interval --enable exp.fast_global_inits
+// Large zero-initialized globals must not be expanded element-wise.
+#include <goblint.h>
+
+struct buffers {
+  int len;
+  char data[1 << 22];
+  int nested[1024][1024];
+};
+
+struct buffers bufs;
+int big[1 << 24];
+int partial[1 << 24] = {1, 2};
+struct buffers bufs_partial = {.len = 5};
+
+int main(void) {
+  __goblint_check(bufs.len == 0);
+  __goblint_check(bufs.data[12345] == 0);
+  __goblint_check(bufs.nested[3][1000] == 0);
+  __goblint_check(big[42] == 0);
+
+  __goblint_check(partial[0] >= 0);
+  __goblint_check(partial[0] <= 2);
+  __goblint_check(partial[100] == 0); // UNKNOWN
+
+  __goblint_check(bufs_partial.len == 5);
+  __goblint_check(bufs_partial.data[7] == 0);
+  return 0;
+}
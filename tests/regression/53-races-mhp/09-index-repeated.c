@@ -0,0 +1,28 @@
+// PARAM: --set ana.activated[+] mhp --set ana.activated[+] threadJoins
+// Accesses with equal MHP information share their numbers and cached results in the index.
+#include <pthread.h>
+
+int g;
+int h;
+
+void *t_fun(void *arg) {
+  g++; // NORACE
+  h++; // RACE!
+  g++; // NORACE
+  h++; // RACE!
+  return NULL;
+}
+
+int main() {
+  pthread_t id;
+  g++; // NORACE
+  h++; // NORACE
+  pthread_create(&id, NULL, t_fun, NULL);
+  h++; // RACE!
+  h++; // RACE!
+  pthread_join(id, NULL);
+  g++; // NORACE
+  h++; // NORACE
+  g++; // NORACE
+  return 0;
+}
@@ -0,0 +1,52 @@
+// PARAM: --set ana.base.addresses.domain bitset --enable ana.int.interval
+#include <goblint.h>
+#include <stdlib.h>
+
+int f(int x) { return x + 1; }
+int g(int x) { return x + 2; }
+int h(int x) { return x + 3; }
+
+struct s {
+  int a;
+  int b;
+} s;
+
+int main() {
+  int a, b, c;
+  int r;
+  int *p = NULL;
+  __goblint_check(p == NULL);
+
+  if (r)
+    p = &a;
+  else if (r + 1)
+    p = &b;
+  __goblint_check(p == NULL); // UNKNOWN!
+  __goblint_check(p != &c);
+
+  if (p != NULL) {
+    *p = 5;
+    __goblint_check(p == &a); // UNKNOWN!
+    __goblint_check(p != NULL);
+  }
+
+  // mix addresses without and with offsets in one set
+  int *q = r ? &s.a : &a;
+  q = r ? q : &s.b;
+  __goblint_check(q != NULL);
+  __goblint_check(q != &b);
+
+  // function pointer table
+  int (*fs[3])(int) = {f, g, h};
+  int (*fp)(int) = fs[r % 3];
+  int y = fp(1);
+  __goblint_check(y >= 2);
+  __goblint_check(y <= 4);
+  __goblint_check(y == 2); // UNKNOWN!
+
+  fp = r ? f : NULL;
+  if (fp)
+    __goblint_check(fp == f);
+
+  return 0;
+}
@@ -0,0 +1,28 @@
+// PARAM: --enable ana.int.interval --set ana.context.limit 2
+#include <goblint.h>
+
+int id(int x) { // more than 2 contexts, further ones are merged
+  return x;
+}
+
+int sq(int x) { // at most 2 contexts, stays context-sensitive
+  return x * x;
+}
+
+int main() {
+  int a = id(1);
+  int b = id(2);
+  int c = id(3);
+  int d = id(4);
+  __goblint_check(a == 1); // first contexts are kept
+  __goblint_check(b == 2);
+  __goblint_check(c >= 3);
+  __goblint_check(d <= 4);
+  __goblint_check(c == 3); // UNKNOWN!
+
+  int e = sq(2);
+  int f = sq(3);
+  __goblint_check(e == 4);
+  __goblint_check(f == 9);
+  return 0;
+}
@@ -0,0 +1,22 @@
+// PARAM: --enable solvers.td3.scc-wpoint --set solvers.td3.widen_gas 5 --enable ana.int.interval
+#include <goblint.h>
+
+int main(void) {
+  int a;
+  int i, j;
+
+  for(a = 0; a != 3; a ++) // wpoint with gas from the start
+    __goblint_check(a < 3);
+
+  for(i = 0; i < 10; i++) {
+    for(j = 0; j < i; j++) // nested loop heads are also pre-seeded
+      __goblint_check(j < 10);
+  }
+  __goblint_check(i == 10);
+
+  do {
+    a--;
+  } while (a > 0);
+  __goblint_check(a <= 0);
+  return 0;
+}
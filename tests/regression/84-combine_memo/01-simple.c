@@ -0,0 +1,29 @@
+// PARAM: --set ana.opt.combine-memo 16 --enable ana.int.interval
+#include <goblint.h>
+
+int g;
+
+int inc(int x) {
+  return x + 1;
+}
+
+int read_global(int x) {
+  return x + g;
+}
+
+int main() {
+  int i = 0;
+  int s = 0;
+  while (i < 10) {
+    i = inc(i); // same combine in every iteration once i is widened
+    s = read_global(s); // reads global, not memoized
+  }
+  __goblint_check(i >= 10);
+  __goblint_check(s == 0);
+
+  int j = inc(1);
+  int k = inc(1);
+  __goblint_check(j == 2);
+  __goblint_check(k == 2);
+  return 0;
+}
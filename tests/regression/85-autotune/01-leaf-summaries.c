@@ -0,0 +1,31 @@
+// PARAM: --enable ana.int.interval --set sem.int.signed_overflow assume_none --set ana.activated[+] apron --set ana.apron.domain polyhedra --enable ana.autotune.enabled --set ana.autotune.activated "['leafSummaries']"
+#include <goblint.h>
+
+int add(int a, int b) { // leaf, analyzed once for both calls
+  return a + b;
+}
+
+void set(int *p, int v) { // leaf, analyzed once per pointer
+  *p = v;
+}
+
+int twice(int a) { // not a leaf
+  return add(a, a);
+}
+
+int main() {
+  int x = add(1, 2);
+  int y = add(3, 4);
+  __goblint_check(x == 3); // relational summary instantiated at call
+  __goblint_check(y == 7);
+
+  int a, b;
+  set(&a, 1);
+  set(&b, 2);
+  __goblint_check(a >= 1);
+  __goblint_check(b <= 2);
+
+  int z = twice(5);
+  __goblint_check(z >= 2);
+  return 0;
+}
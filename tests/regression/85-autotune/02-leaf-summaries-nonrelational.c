@@ -0,0 +1,14 @@
+// PARAM: --enable ana.int.interval --enable ana.autotune.enabled --set ana.autotune.activated "['leafSummaries']"
+#include <goblint.h>
+
+int add(int a, int b) { // leaf, but stays context-sensitive without relational analysis
+  return a + b;
+}
+
+int main() {
+  int x = add(1, 2);
+  int y = add(3, 4);
+  __goblint_check(x == 3);
+  __goblint_check(y == 7);
+  return 0;
+}
@@ -0,0 +1,31 @@
+#include <pthread.h>
+
+int g;
+int h;
+pthread_mutex_t m = PTHREAD_MUTEX_INITIALIZER;
+
+void *worker(void *arg) {
+  g++; // RACE!
+  pthread_mutex_lock(&m);
+  h++; // NORACE
+  pthread_mutex_unlock(&m);
+  return NULL;
+}
+
+void *single(void *arg) {
+  int i = 0;
+  while (i < 10)
+    i++;
+  return NULL;
+}
+
+int main() {
+  pthread_t t, ts[10];
+  pthread_create(&t, NULL, single, NULL);
+  for (int i = 0; i < 10; i++)
+    pthread_create(&ts[i], NULL, worker, NULL);
+  pthread_mutex_lock(&m);
+  h++; // NORACE
+  pthread_mutex_unlock(&m);
+  return 0;
+}
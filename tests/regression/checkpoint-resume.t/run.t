@@ -0,0 +1,20 @@
+Resuming from a checkpoint gives the same results as an uninterrupted run.
+
+  $ goblint --enable warn.deterministic checkpoint.c > uninterrupted.txt 2> /dev/null
+
+Abort deterministically after a number of evaluations, writing a checkpoint with the analysis data.
+
+  $ goblint --enable warn.deterministic --set incremental.checkpoint.abort-after 10 checkpoint.c > /dev/null 2>&1
+  [124]
+
+  $ ls incremental_data/results
+  analysis.data
+
+  $ goblint --enable warn.deterministic --resume checkpoint.c > resumed.txt 2> /dev/null
+
+  $ diff uninterrupted.txt resumed.txt
+
+The results include the race on the variable accessed by non-unique threads.
+
+  $ grep -c "\[Warning\]\[Race\] Memory location g " resumed.txt
+  1
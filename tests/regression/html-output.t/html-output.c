@@ -0,0 +1,7 @@
+#include <goblint.h>
+
+int main() {
+  int x = 1;
+  __goblint_check(x == 2); // FAIL
+  return 0;
+}
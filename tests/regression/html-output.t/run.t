@@ -0,0 +1,26 @@
+Generate native HTML output.
+
+  $ goblint --html html-output.c > /dev/null 2>&1
+
+  $ ls result
+  cfgs
+  files
+  globals.html
+  index.html
+  nodes
+  style.css
+  warnings.html
+
+  $ ls result/files
+  0.html
+
+  $ ls result/cfgs/0 | grep html
+  main.html
+
+Warnings link to the line on the file page.
+
+  $ grep -o 'href="files/0.html#l[0-9]*"' result/warnings.html
+  href="files/0.html#l5"
+
+  $ grep -c 'id="l5" class="warn"' result/files/0.html
+  1
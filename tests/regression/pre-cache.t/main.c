@@ -0,0 +1,11 @@
+#include <goblint.h>
+#include "header.h"
+
+int f(int x) {
+  return x + 1;
+}
+
+int main() {
+  __goblint_check(f(1) == 2);
+  return 0;
+}
@@ -0,0 +1,32 @@
+Preprocessed files are cached in goblint-dir and reused if the preprocessing command and all included files are unchanged.
+
+  $ goblint --enable pre.cache main.c 2>&1 | grep "Preprocessing cache"
+  [Info] Preprocessing cache: 0 hits, 1 misses
+
+An unchanged run restores the preprocessed file from the cache.
+
+  $ goblint --enable pre.cache main.c 2>&1 | grep "Preprocessing cache"
+  [Info] Preprocessing cache: 1 hits, 0 misses
+
+A changed included header is preprocessed again.
+
+  $ echo 'int g(int x);' >> header.h
+
+  $ goblint --enable pre.cache main.c 2>&1 | grep "Preprocessing cache"
+  [Info] Preprocessing cache: 0 hits, 1 misses
+
+  $ goblint --enable pre.cache main.c 2>&1 | grep "Preprocessing cache"
+  [Info] Preprocessing cache: 1 hits, 0 misses
+
+A changed preprocessing command is preprocessed again.
+
+  $ goblint --enable pre.cache --set pre.cppflags[+] -DFOO main.c 2>&1 | grep "Preprocessing cache"
+  [Info] Preprocessing cache: 0 hits, 1 misses
+
+The analysis results are the same with a restored preprocessed file.
+
+  $ goblint main.c > uncached.txt 2> /dev/null
+
+  $ goblint --enable pre.cache main.c > cached.txt 2> /dev/null
+
+  $ diff uncached.txt cached.txt
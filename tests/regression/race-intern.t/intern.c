@@ -0,0 +1,26 @@
+#include <pthread.h>
+
+int g;
+int h;
+pthread_mutex_t m = PTHREAD_MUTEX_INITIALIZER;
+
+void *t_fun(void *arg) {
+  for (int i = 0; i < 10; i++) {
+    pthread_mutex_lock(&m);
+    h++; // NORACE
+    pthread_mutex_unlock(&m);
+    g++; // RACE!
+  }
+  return NULL;
+}
+
+int main() {
+  pthread_t id[2];
+  for (int i = 0; i < 2; i++)
+    pthread_create(&id[i], NULL, t_fun, NULL);
+  pthread_mutex_lock(&m);
+  h++; // NORACE
+  pthread_mutex_unlock(&m);
+  g++; // RACE!
+  return 0;
+}
@@ -0,0 +1,21 @@
+Interning race accesses does not change the results.
+
+  $ goblint --enable warn.deterministic --enable ana.race.intern intern.c > interned.txt 2> /dev/null
+
+  $ goblint --enable warn.deterministic --disable ana.race.intern intern.c > plain.txt 2> /dev/null
+
+  $ diff interned.txt plain.txt
+
+  $ grep -c "\[Warning\]\[Race\] Memory location g " interned.txt
+  1
+
+Accesses in the loop are re-evaluated, so equal accesses are interned again.
+
+  $ goblint --enable ana.race.intern --set dbg.level debug intern.c 2>&1 | grep -c "interned accesses: [1-9][0-9]* ([1-9][0-9]* payloads, [0-9]* words), hits: [1-9]"
+  1
+
+Without interning, nothing is interned.
+
+  $ goblint --disable ana.race.intern --set dbg.level debug intern.c 2>&1 | grep -c "interned accesses"
+  0
+  [1]
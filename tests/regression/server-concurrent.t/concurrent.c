@@ -0,0 +1,7 @@
+// Loops, so that analyze has right-hand sides to evaluate after the first poll.
+#define F(n) int f##n(int k) { int s = 0; for (int i = 0; i < k; i++) { for (int j = 0; j < i; j++) s += j; } return s; }
+F(0) F(1) F(2) F(3)
+
+int main() {
+  return f0(10) + f1(20) + f2(30) + f3(40);
+}
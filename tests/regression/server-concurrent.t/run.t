@@ -0,0 +1,15 @@
+Answer a read-only request from the snapshot of the previous analysis while the second analyze is running.
+The request needs the lazy maps of the file, which must not leak into the running analysis.
+The second analyze waits for the request at its first poll, the other requests are only sent after the response to the previous one.
+
+  $ wait_for() { for i in $(seq 600); do grep -q "\"id\":$1[,}]" out 2> /dev/null && return; sleep 0.1; done; }
+  $ (echo '{"jsonrpc":"2.0","id":1,"method":"analyze","params":{}}'; wait_for 1;
+  >  echo '{"jsonrpc":"2.0","id":2,"method":"analyze","params":{"reset":true}}';
+  >  echo '{"jsonrpc":"2.0","id":3,"method":"node_state","params":{"nid":"1"}}'; wait_for 2;
+  >  echo '{"jsonrpc":"2.0","id":4,"method":"messages","params":{}}'; wait_for 4) | goblint --enable server.enabled --enable server.reparse --enable dbg.test.server-await-request concurrent.c > out 2> /dev/null
+
+  $ grep -o '"id":[0-9]*' out
+  "id":1
+  "id":3
+  "id":2
+  "id":4
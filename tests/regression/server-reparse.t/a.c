@@ -0,0 +1,10 @@
+#include <goblint.h>
+
+int f(int x);
+int g(void);
+
+int main() {
+  int x = f(1);
+  __goblint_check(x == 2);
+  return g();
+}
@@ -0,0 +1,7 @@
+int f(int x) {
+  return x + 1;
+}
+
+int g(void) {
+  return 0;
+}
@@ -0,0 +1,24 @@
+Requests are only sent after the response to the previous one, such that the source file can be changed in between.
+
+  $ wait_for() { for i in $(seq 600); do grep -q "\"id\":$1[,}]" out 2> /dev/null && return; sleep 0.1; done; }
+  $ (echo '{"jsonrpc":"2.0","id":1,"method":"analyze","params":{}}'; wait_for 1;
+  >  echo 'int h(void) { return 2; }' >> b.c;
+  >  echo '{"jsonrpc":"2.0","id":2,"method":"analyze","params":{}}'; wait_for 2;
+  >  echo '{"jsonrpc":"2.0","id":3,"method":"analyze","params":{"functions":["f"]}}'; wait_for 3) | goblint --enable server.enabled --enable server.reparse a.c b.c > out 2> err
+
+Only the changed translation unit is parsed again, the initial parse happens before the server starts.
+
+  $ grep -o "[0-9]* parsed$" err | tail -n 3
+  0 parsed
+  1 parsed
+  0 parsed
+
+Only the function requested by the client is reanalyzed without being changed.
+
+  $ grep "Completely changed function" err
+  [Info] Completely changed function: f
+
+  $ grep -o '"status":\["[A-Za-z]*"\]' out
+  "status":["Success"]
+  "status":["Success"]
+  "status":["Success"]
@@ -0,0 +1,23 @@
+The explicit-stack variant of td3 gives the same results as td3, even if (almost) every query is aborted.
+
+  $ goblint --enable warn.deterministic --enable ana.int.interval --set solver td3 stack.c > td3.txt 2> /dev/null
+
+  $ goblint --enable warn.deterministic --enable ana.int.interval --set solver td_stack stack.c > td_stack.txt 2> /dev/null
+
+  $ diff td3.txt td_stack.txt
+
+  $ goblint --enable warn.deterministic --enable ana.int.interval --set solver td_stack --set solvers.td3.max-depth 1 stack.c > depth1.txt 2> /dev/null
+
+  $ diff td3.txt depth1.txt
+
+  $ goblint --enable warn.deterministic --enable ana.int.interval --set solver td_stack --set solvers.td3.max-depth 1 --enable solvers.td3.skip-unchanged-rhs stack.c > depvals.txt 2> /dev/null
+
+  $ diff td3.txt depvals.txt
+
+The results are not trivial.
+
+  $ grep -c "\[Warning\]\[Race\] Memory location g " td3.txt
+  1
+
+  $ grep -c "\[Success\]\[Assert\]" td3.txt
+  2
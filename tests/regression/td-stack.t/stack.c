@@ -0,0 +1,43 @@
+#include <pthread.h>
+#include <goblint.h>
+
+int g;
+pthread_mutex_t m = PTHREAD_MUTEX_INITIALIZER;
+
+// Long chain of calls, each with a loop, to nest right-hand sides deeply.
+#define STEP(n, next) int f##n(int x) { for (int i = 0; i < 3; i++) x++; return next(x); }
+int f0(int x) { return x; }
+STEP(1, f0) STEP(2, f1) STEP(3, f2) STEP(4, f3) STEP(5, f4) STEP(6, f5) STEP(7, f6) STEP(8, f7)
+STEP(9, f8) STEP(10, f9) STEP(11, f10) STEP(12, f11) STEP(13, f12) STEP(14, f13) STEP(15, f14) STEP(16, f15)
+
+int rec(int n) {
+  if (n <= 0)
+    return 0;
+  return rec(n - 1) + 1;
+}
+
+void *worker(void *arg) {
+  pthread_mutex_lock(&m);
+  g = f16(g);
+  pthread_mutex_unlock(&m);
+  g++; // RACE!
+  return NULL;
+}
+
+int main() {
+  pthread_t t;
+  pthread_create(&t, NULL, worker, NULL);
+  int j = 0;
+  for (int i = 0; i < 100; i++) {
+    for (int k = 0; k < i; k++)
+      j++;
+  }
+  __goblint_check(j >= 0);
+  int r = rec(5);
+  __goblint_check(r >= 0);
+  __goblint_check(f16(0) == 48); // UNKNOWN
+  pthread_mutex_lock(&m);
+  g = 1; // RACE!
+  pthread_mutex_unlock(&m);
+  return 0;
+}
@@ -0,0 +1,17 @@
+#include <goblint.h>
+
+int g;
+
+int f(int x) {
+  g = x;
+  return x + 1;
+}
+
+int main() {
+  int i = 0;
+  while (i < 10)
+    i = f(i);
+  __goblint_check(i >= 10);
+  __goblint_check(g < 10); // UNKNOWN
+  return 0;
+}
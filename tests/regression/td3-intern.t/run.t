@@ -0,0 +1,12 @@
+Incremental data of td3 with numbered variables can be loaded with numbered variables.
+
+  $ goblint --enable warn.deterministic --enable solvers.td3.intern --enable incremental.save intern.c > saved.txt 2> /dev/null
+
+  $ goblint --enable warn.deterministic --enable solvers.td3.intern --enable incremental.load intern.c > loaded.txt 2> /dev/null
+
+  $ diff saved.txt loaded.txt
+
+It is rejected without numbered variables, because the solver data has a different representation.
+
+  $ goblint --enable warn.deterministic --enable incremental.load intern.c 2>&1 | grep -o "Incremental data was stored with solvers.td3.intern = true"
+  Incremental data was stored with solvers.td3.intern = true